@@ -7,6 +7,8 @@
 #include "settings/Settings.h"
 #include "utils/Utils.h"
 #include "parser/evtc_parser.h"
+#include "parser/directory_monitor.h"
+#include "parser/parse_scheduler.h"
 #include "integration/MursaatPanelIntegration.h"
 #include "resource.h"
 
@@ -133,10 +135,20 @@ void AddonUnload() {
     APIDefs->Renderer.Deregister(AddonRender);
     APIDefs->Renderer.Deregister(AddonOptions);
 
-    stopMonitoring = true;
+    // The benchmark thread logs through APIDefs, so it must finish before unload
+    if (g_optionsWindow) {
+        g_optionsWindow->StopBenchmark();
+    }
+
+    auto stopRequested = std::chrono::steady_clock::now();
+    requestStopMonitoring();
     if (directoryMonitorThread.joinable()) {
         directoryMonitorThread.join();
     }
+    auto stopElapsed = std::chrono::steady_clock::now() - stopRequested;
+    parseMetrics.monitorShutdown.record(stopElapsed);
+    APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME, ("Directory monitoring stopped in " +
+        std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(stopElapsed).count()) + " ms.").c_str());
     if (initialParsingThread.joinable()) {
         initialParsingThread.join();
     }
@@ -176,6 +188,7 @@ void AddonUnload() {
 }
 
 void AddonRender() {
+    parseScheduler.recordFrame();
     if (g_windowRenderer) {
         g_windowRenderer->RenderAllWindows(hSelf);
     }
@@ -23,6 +23,14 @@ struct TemplateVariable {
     size_t position;
 };
 
+// Which part of a log's skill table a spec bar's tooltip breaks down
+struct SkillBreakdownSource {
+    const SkillStatsTable* table = nullptr;
+    // The raw team IDs shown under the bar's team name
+    std::vector<uint32_t> teamIDs;
+    bool squadOnly = false;
+};
+
 struct BarTemplateDefaults {
     static const inline std::unordered_map<std::string, std::string> defaultTemplates = {
         {"players", "{1} {2} {3} ({4})"},
@@ -46,7 +54,8 @@ public:
         const std::string& sortType,
         HINSTANCE hSelf,
         float fontSize,
-        bool showTooltips
+        bool showTooltips,
+        const SkillBreakdownSource* skillSource = nullptr
     );
     static std::string GetTemplateForSort(
         const std::string& sortType,
@@ -58,7 +67,8 @@ public:
     static void RenderTooltipStats(
         const SpecStats& stats,
         bool vsLoggedPlayersOnly,
-        int playerCount
+        int playerCount,
+        const std::vector<SkillTotals>* topSkills = nullptr
     );
 
 private:
@@ -21,11 +21,23 @@ namespace wvwfightanalysis::gui {
         void Render(HINSTANCE hSelf, MainWindowSettings* settings);
 
     private:
-        void RenderTeamData(const TeamStats& teamData,
+        void RenderTeamData(const ParsedData& logData,
+            const TeamStats& teamData,
             const std::string& teamName,
             const MainWindowSettings* settings,
             HINSTANCE hSelf);
-        void RenderSpecializationBars(const TeamStats& teamData,
+        void RenderTimeRangeSlider(ParsedLog& log,
+            const MainWindowSettings* settings);
+        void RenderTeamTimeline(const TeamStats& teamData,
+            const MainWindowSettings* settings);
+        void RenderSubgroupPanel(const SquadStats& squad,
+            const MainWindowSettings* settings);
+        void RenderTopPlayers(const ParsedData& logData,
+            const TeamStats& teamData,
+            const std::string& teamName,
+            const MainWindowSettings* settings);
+        void RenderSpecializationBars(const ParsedData& logData,
+            const TeamStats& teamData,
             const std::string& teamName,
             const MainWindowSettings* settings,
             HINSTANCE hSelf);
@@ -44,6 +56,14 @@ namespace wvwfightanalysis::gui {
             ImVec4& primary,
             ImVec4& secondary
         ) const;
+
+        // The log the time range was picked on
+        std::string m_rangeLogFilename;
+        // Bucket edges of the range index, so the range shown is exactly
+        // the range picked
+        int m_rangeEdges[2] = { 0, 0 };
+        // The buckets this frame's stats were sliced to; both 0 for the whole fight
+        size_t m_rangeBuckets[2] = { 0, 0 };
     };
 
 } // namespace wvwfightanalysis::gui
\ No newline at end of file
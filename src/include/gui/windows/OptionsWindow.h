@@ -1,10 +1,35 @@
 #pragma once
 
+#include "parser/evtc_parser.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace wvwfightanalysis::gui {
 
     class OptionsWindow {
     public:
+        ~OptionsWindow();
+
         void Render();
+
+        // Cancels a running accumulation benchmark and waits for its thread.
+        void StopBenchmark();
+
+    private:
+        void RenderAccumulationBenchmark();
+
+        std::thread benchmarkThread;
+        std::atomic<bool> benchmarkRunning{ false };
+        std::atomic<bool> benchmarkCancelled{ false };
+        std::mutex benchmarkMutex;
+        std::vector<AccumulationBenchmarkRun> benchmarkRuns;
+        std::string benchmarkLog;
+
+        // Set when a history setting changed, cleared once it is applied
+        bool historyRefreshPending = false;
     };
 
 } // namespace wvwfightanalysis::gui
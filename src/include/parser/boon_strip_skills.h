@@ -1,11 +1,37 @@
 #ifndef BOON_STRIP_SKILLS_H
 #define BOON_STRIP_SKILLS_H
 
-#include <unordered_set>
 #include <cstdint>
 
+struct BoonStripSkill {
+    uint32_t id;
+    const char* name;
+};
+
 // Define known boon strip skills
-extern const std::unordered_set<uint32_t> knownBoonStripSkills;
+inline constexpr BoonStripSkill knownBoonStripSkills[] = {
+    { 10602, "Corrupt Boon" },              // Necro
+    { 10698, "Null Field" },                // Mesmer
+    { 30792, "Break Enchantments" },        // Warrior
+    { 30088, "Winds of Disenchantment" },   // Spellbreaker
+    // Add more known boon strip skills as identified
+};
+
+/**
+ * @brief Check if a skill is a known boon strip skill
+ * @param skillId The skill ID to check
+ * @return True if the skill is in knownBoonStripSkills
+ *
+ * One bit test in a table built at compile time, so it is cheap enough to
+ * run on every skill cast of a log.
+ */
+bool isBoonStripSkill(uint32_t skillId);
 
+/**
+ * @brief Look up the name of a known boon strip skill
+ * @param skillId The skill ID
+ * @return The skill's name, or nullptr if it is not a known strip skill
+ */
+const char* getBoonStripSkillName(uint32_t skillId);
 
-#endif // BOON_STRIP_SKILLS_H
\ No newline at end of file
+#endif // BOON_STRIP_SKILLS_H
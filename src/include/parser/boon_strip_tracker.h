@@ -4,28 +4,45 @@
 
 #include "shared/Shared.h" // Include this first
 #include "boon_strip_skills.h"
+#include <array>
 #include <unordered_map>
-#include <vector>
 #include <cstdint>
-#include <algorithm> // For std::remove_if
 
+/**
+ * @brief Remembers each agent's latest boon strip skill casts to attribute strips to them
+ *
+ * Every agent gets a fixed ring of its last kActivationsPerAgent strip skill
+ * casts, so tracking a cast overwrites the oldest one in place and nothing
+ * ever needs pruning.
+ */
 class BoonStripTracker {
-private:
-    // Maps player instid to timestamps of strip skill activations
-    std::unordered_map<uint16_t, std::vector<uint64_t>> playerSkillActivations;
-    const uint64_t DEFAULT_WINDOW_MS = 500; // Default temporal window
-    const uint64_t CLEANUP_INTERVAL_MS = 5000; // Cleanup interval
-    uint64_t lastCleanupTime = 0;
-
 public:
+    static constexpr size_t kActivationsPerAgent = 8;
+    static constexpr uint64_t kDefaultWindowMs = 500;
+
     // Track a skill activation if it's a known strip skill
     void trackSkillActivation(uint16_t srcInstid, uint32_t skillId, uint64_t timestamp);
 
+    // The strip skill a player started most recently within the window
+    // before currentTime, or 0 if there is none
+    uint32_t findRecentStripSkill(uint16_t instid, uint64_t currentTime,
+        uint64_t windowMs = kDefaultWindowMs) const;
+
     // Check if a player has recently used a strip skill
-    bool hasRecentStripSkill(uint16_t instid, uint64_t currentTime, uint64_t windowMs = 0);
+    bool hasRecentStripSkill(uint16_t instid, uint64_t currentTime, uint64_t windowMs = kDefaultWindowMs) const {
+        return findRecentStripSkill(instid, currentTime, windowMs) != 0;
+    }
+
+private:
+    struct ActivationRing {
+        std::array<uint64_t, kActivationsPerAgent> times{};
+        std::array<uint32_t, kActivationsPerAgent> skillIds{};
+        // The slot the next cast goes into, and how many slots are filled
+        uint8_t next = 0;
+        uint8_t size = 0;
+    };
 
-    // Periodically clean up old activations
-    void cleanupOldActivations(uint64_t currentTime, uint64_t expirationMs = 0);
+    std::unordered_map<uint16_t, ActivationRing> activationsByInstid;
 };
 
-#endif // BOON_STRIP_TRACKER_H
\ No newline at end of file
+#endif // BOON_STRIP_TRACKER_H
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * @brief Blocking queue with a fixed capacity per priority lane.
+ *
+ * push() waits while its lane is full and pop() waits while every lane is
+ * empty; pop() always serves the lowest-numbered non-empty lane, and since
+ * each lane has its own capacity a full low-priority lane never blocks a
+ * more urgent producer. After close(), push() fails and pop() hands out what
+ * is left before returning nullopt.
+ */
+template <typename T, size_t LaneCount = 2>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacityPerLane) : capacityPerLane(capacityPerLane) {}
+
+    bool push(T item, size_t lane) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return closed || lanes[lane].size() < capacityPerLane; });
+        if (closed) {
+            return false;
+        }
+        lanes[lane].push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&] { return closed || !isEmpty(); });
+        for (auto& items : lanes) {
+            if (!items.empty()) {
+                T item = std::move(items.front());
+                items.pop_front();
+                notFull.notify_all();
+                return item;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    void clear() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& items : lanes) {
+                items.clear();
+            }
+        }
+        notFull.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t total = 0;
+        for (const auto& items : lanes) {
+            total += items.size();
+        }
+        return total;
+    }
+
+private:
+    bool isEmpty() const {
+        for (const auto& items : lanes) {
+            if (!items.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::array<std::deque<T>, LaneCount> lanes;
+    size_t capacityPerLane;
+    bool closed = false;
+};
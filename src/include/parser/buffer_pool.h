@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Small pool of reusable byte buffers for log decompression.
+ *
+ * Buffers keep their size between leases so a log no bigger than a previous
+ * one is read and inflated without touching the heap. Buffers that grew past
+ * the retention cap are freed on release instead of being kept around.
+ * A lease may be released on a different thread than the one that acquired it.
+ */
+class BufferPool {
+public:
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(BufferPool* pool, std::vector<char>&& buffer);
+        ~Lease();
+
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        std::vector<char>& get() { return buffer; }
+        std::vector<char>& operator*() { return buffer; }
+        std::vector<char>* operator->() { return &buffer; }
+
+    private:
+        BufferPool* pool = nullptr;
+        std::vector<char> buffer;
+    };
+
+    BufferPool(size_t maxIdleBuffers, size_t maxRetainedBytesPerBuffer);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    Lease acquire();
+    size_t retainedBytes() const;
+    void trim();
+
+private:
+    void release(std::vector<char>&& buffer);
+
+    mutable std::mutex mutex;
+    std::vector<std::vector<char>> idleBuffers;
+    size_t maxIdleBuffers;
+    size_t maxRetainedBytesPerBuffer;
+};
+
+/**
+ * @brief Decompression buffers owned by the calling thread.
+ *
+ * Only the read fallback in extractZipFile, for archives that cannot be
+ * mapped, and the one-off parseEVTCFile use it; the parse pipeline owns its
+ * own pool. The pool lives as long as the thread that used it.
+ */
+BufferPool& getDecompressionBufferPool();
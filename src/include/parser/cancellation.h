@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "parser/parse_scheduler.h"
+
+/**
+ * @brief Read side of a stop flag, handed down into long-running parse loops.
+ *
+ * A default-constructed token is never cancelled. Hot loops call poll(),
+ * which only reads the flag every few thousand calls, so a stop request is
+ * honoured within a fraction of a millisecond however large the log is.
+ * Coarser loops call checkpoint() every time. Given a scheduler, each
+ * checkpoint is also where the thread yields to the game in combat.
+ * A token belongs to one job on one thread; copy it rather than share it.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    explicit CancellationToken(const std::atomic<bool>& flag, ParseScheduler* scheduler = nullptr)
+        : flag(&flag), scheduler(scheduler) {}
+
+    bool isCancelled() const {
+        return flag && flag->load(std::memory_order_relaxed);
+    }
+
+    bool checkpoint() const {
+        if (scheduler) {
+            scheduler->pace();
+        }
+        return isCancelled();
+    }
+
+    bool poll() const {
+        return (++pollCount & kPollMask) == 0 && checkpoint();
+    }
+
+private:
+    static constexpr uint32_t kPollMask = 4096 - 1;
+
+    const std::atomic<bool>* flag = nullptr;
+    ParseScheduler* scheduler = nullptr;
+    mutable uint32_t pollCount = 0;
+};
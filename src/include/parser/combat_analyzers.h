@@ -0,0 +1,97 @@
+#pragma once
+
+#include "parser/cancellation.h"
+#include "parser/event_classifier.h"
+#include "parser/skill_table.h"
+#include "settings/Settings.h"
+#include "shared/Shared.h"
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * @brief What the first pass learns about the log's agents.
+ *
+ * Instance IDs are reused during a log, so the maps hold the last agent
+ * seen with each ID, as the stats pass has always looked them up.
+ */
+struct LogPassResult {
+    std::unordered_map<uint16_t, Agent*> agentsByInstid;
+    // Agents that dealt or took at least one non-state-change event
+    std::unordered_map<uint64_t, uint16_t> instidByAddress;
+    // Agents that were the source of at least one non-state-change event
+    std::unordered_set<uint64_t> activeAddresses;
+    std::unordered_map<uint64_t, AgentState> agentStates;
+};
+
+/**
+ * @brief Run the first pass: log times, POV, team IDs and colors, agent presence and agent states
+ * @return False if the token was cancelled; the results are then incomplete
+ *
+ * Fills in the combat and log times, logTeamNames, the POV team flag and
+ * each team's players timeline and time-weighted player counts of result,
+ * and each agent's instance and team ID.
+ */
+bool runLogPass(const CombatEventView& events, const EventStreams& streams,
+    std::unordered_map<uint64_t, Agent>& agentsByAddress,
+    std::unordered_map<uint16_t, Agent*>& playersBySrcInstid,
+    ParsedData& result, LogPassResult& pass,
+    const ParserSettingsSnapshot& settings, const CancellationToken& token);
+
+// Everything the stats pass reads. It is all settled by the first pass, so
+// chunks share it without locking.
+struct AccumulationContext {
+    const CombatEventView& events;
+    const EventStreams& streams;
+    const std::unordered_map<uint16_t, Agent*>& playersBySrcInstid;
+    const std::unordered_map<uint16_t, Agent*>& agentsByInstid;
+    const std::unordered_map<uint64_t, AgentState>& agentStates;
+    // The time bucket 0 of each team's timeline starts at, and their length
+    uint64_t combatStartTime;
+    size_t timelineBuckets;
+    const LogSkillTable& skills;
+    // The skill group of each player table row, from assignSkillGroups()
+    const std::vector<uint32_t>& skillGroupByPlayerRow;
+};
+
+/**
+ * @brief Give every agent on a team a row in the player table
+ * @param table Receives each row's name, spec, team ID and squad flag, and
+ * counter columns of as many rows
+ *
+ * Needs the team IDs and POV team flag the first pass settles.
+ */
+void assignPlayerRows(std::unordered_map<uint64_t, Agent>& agentsByAddress, const ParsedData& result,
+    PlayerStatsTable& table);
+
+/**
+ * @brief Sort the player table's rows into skill groups by team ID, spec and squad membership
+ * @param players The player table from assignPlayerRows()
+ * @param table Receives one empty group per distinct team ID, spec and squad flag
+ * @return The group of each player row
+ */
+std::vector<uint32_t> assignSkillGroups(const PlayerStatsTable& players, SkillStatsTable& table);
+
+/**
+ * @brief Run the stats pass over events [begin, end): deaths, downs, damage, strips and kills
+ * @param teamStatsById The stats to add into, with the POV team's flag already set
+ * @param rangeIndex The range index to add each event's per-bucket delta into,
+ * with its start time and bucket count already set
+ * @param players The player counters to add into, sized by assignPlayerRows()
+ * @param skills The per-skill counters to add into, sized by the skill groups and the log's skill table
+ *
+ * Also fills each team's per-second timeline, sized from the context, and
+ * its strips by skill. Strip skill casts in the half second before begin are
+ * replayed first, so chunks attribute strips as one pass over the log would.
+ */
+void accumulateEventRange(const AccumulationContext& context, size_t begin, size_t end,
+    std::unordered_map<uint32_t, TeamStats>& teamStatsById, FightRangeIndex& rangeIndex,
+    PlayerCounters& players, SkillCounters& skills, const CancellationToken& token);
+
+/**
+ * @brief Count each team's players and specs, and the POV squad's parties, from the agents seen in the first pass
+ *
+ * Squad members count once per account, everyone else once per instance ID.
+ */
+void countPlayers(const std::unordered_map<uint64_t, Agent>& agentsByAddress, const LogPassResult& pass,
+    ParsedData& result, const ParserSettingsSnapshot& settings);
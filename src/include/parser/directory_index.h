@@ -0,0 +1,59 @@
+#pragma once
+
+#include "parser/cancellation.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief In-memory index of the log files under the arcdps log directory.
+ *
+ * Keeps path, size and last write time for every accepted log so new logs
+ * can be found and ordered without walking and stat-ing the whole tree.
+ * Kept up to date from file-watch events, reconciled against the disk by an
+ * occasional full walk, and saved next to the settings between sessions.
+ */
+class DirectoryIndex {
+public:
+    struct Entry {
+        std::filesystem::path path;
+        uint64_t size = 0;
+        std::filesystem::file_time_type lastWriteTime{};
+    };
+
+    using Filter = std::function<bool(const std::filesystem::path&)>;
+
+    void setRoot(const std::filesystem::path& dirPath, Filter filter);
+    const std::filesystem::path& getRoot() const { return root; }
+
+    // Full walk of the root. Returns the entries that were added or changed.
+    // Files already indexed are compared by size and write time only; the
+    // filter runs on new paths. A cancelled walk leaves the index as it was.
+    std::vector<Entry> reconcile(const CancellationToken& token = {});
+
+    // Re-stats a single file after a change notification. Returns true if the
+    // file is an accepted log that was added or changed.
+    bool update(const std::filesystem::path& filePath, Entry* outEntry = nullptr);
+    void remove(const std::filesystem::path& filePath);
+
+    // Accepted logs ordered oldest first.
+    std::vector<Entry> getFilesNewerThan(std::filesystem::file_time_type time) const;
+    // The newest count logs, newest first.
+    std::vector<Entry> getNewestFiles(size_t count) const;
+
+    size_t size() const { return entries.size(); }
+    size_t getMemoryUsage() const;
+
+    bool load(const std::filesystem::path& indexPath);
+    bool save(const std::filesystem::path& indexPath) const;
+
+private:
+    static std::wstring makeKey(const std::filesystem::path& filePath);
+
+    std::filesystem::path root;
+    Filter filter;
+    std::unordered_map<std::wstring, Entry> entries;
+};
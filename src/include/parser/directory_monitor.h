@@ -1,5 +1,19 @@
 #pragma once
 
 #include <cstddef>
+#include <filesystem>
 
 void monitorDirectory(size_t numLogsToParse, size_t pollIntervalMilliseconds);
+
+// Sets stopMonitoring and cuts short whatever the monitor thread is doing:
+// the directory watch wait, queued logs and any inflate or parse in flight.
+// The caller still joins directoryMonitorThread.
+void requestStopMonitoring();
+
+// Memory held by the monitor's directory index and by the parse pipeline's
+// idle inflate buffers. Safe to call from any thread.
+size_t getLogIndexMemoryUsage();
+size_t getParseBufferMemoryUsage();
+
+// The largest WvW log published this session, or an empty path.
+std::filesystem::path getLargestParsedLogPath();
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "parser/cancellation.h"
+#include "shared/Shared.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Indices of the events each parse pass cares about, in log order.
+ *
+ * Built by one scan of the event block so the later passes skip straight
+ * to their events instead of re-testing every event's flag bytes.
+ */
+struct EventStreams {
+    // Direct hits and condition ticks: no activation or buff removal, and a
+    // Normal, Critical, Glance or KillingBlow result, split by the buff byte
+    std::vector<uint32_t> strikeDamage;
+    std::vector<uint32_t> condiDamage;
+    // The KillingBlow hits among those, whatever their buff byte
+    std::vector<uint32_t> killingBlows;
+    // Removals of every stack of a buff
+    std::vector<uint32_t> strips;
+    // Every state change: log metadata, team changes, GUIDs, downs, deaths
+    // and health updates
+    std::vector<uint32_t> stateChanges;
+    // Skill casts starting, with or without quickness
+    std::vector<uint32_t> activations;
+};
+
+/**
+ * @brief Sort the events into per-kind index streams.
+ *
+ * Uses SSE2 four events at a time where it is available and a scalar loop
+ * otherwise; both give the same streams. Stops early once the token is
+ * cancelled, leaving the streams incomplete.
+ */
+EventStreams classifyEvents(const CombatEventView& events, const CancellationToken& token = {});
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "parser/cancellation.h"
+#include "parser/event_classifier.h"
+#include "shared/Shared.h"
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// The event kinds an analyzer can ask for. All but Any have a stream in
+// EventStreams; an event can be of several kinds, e.g. a strike that is
+// also a killing blow.
+enum class EventKind : uint8_t {
+    StrikeDamage = 0,
+    CondiDamage = 1,
+    KillingBlow = 2,
+    Strip = 3,
+    StateChange = 4,
+    Activation = 5,
+    // Every event, whatever its kind
+    Any = 6
+};
+
+template <EventKind Kind>
+using EventTag = std::integral_constant<EventKind, Kind>;
+
+constexpr uint32_t eventKindBit(EventKind kind) {
+    return 1u << static_cast<uint32_t>(kind);
+}
+
+inline const std::vector<uint32_t>& getEventStream(const EventStreams& streams, EventKind kind) {
+    switch (kind) {
+    case EventKind::StrikeDamage: return streams.strikeDamage;
+    case EventKind::CondiDamage: return streams.condiDamage;
+    case EventKind::KillingBlow: return streams.killingBlows;
+    case EventKind::Strip: return streams.strips;
+    case EventKind::Activation: return streams.activations;
+    default: return streams.stateChanges;
+    }
+}
+
+/**
+ * @brief One pass over the events that feeds every analyzer it was built with.
+ *
+ * An analyzer declares the kinds it consumes as a mask of eventKindBit()s in
+ * a static constexpr kEventKinds, and takes each of them in an overload of
+ * onEvent(EventTag<Kind>, const CombatEvent&). The pipeline walks only the
+ * streams some analyzer consumes, merged back into log order, and calls the
+ * interested analyzers for each event, Any first and then the event's kinds
+ * in enum order. Which analyzer gets which kind is settled at compile time,
+ * so an analyzer costs only its own work.
+ */
+template <typename... Analyzers>
+class EventPipeline {
+public:
+    explicit EventPipeline(Analyzers&... analyzers) : analyzers(analyzers...) {}
+
+    // Dispatches the events with indices in [begin, end). Returns false if
+    // the token was cancelled part way.
+    bool run(const CombatEventView& events, const EventStreams& streams, size_t begin, size_t end,
+        const CancellationToken& token) {
+        struct Cursor {
+            const uint32_t* next = nullptr;
+            const uint32_t* last = nullptr;
+        };
+        Cursor cursors[kStreamKinds];
+        for (uint32_t kind = 0; kind < kStreamKinds; ++kind) {
+            if (kConsumedKinds & (1u << kind)) {
+                const std::vector<uint32_t>& stream = getEventStream(streams, static_cast<EventKind>(kind));
+                const uint32_t* streamEnd = stream.data() + stream.size();
+                cursors[kind].next = std::lower_bound(stream.data(), streamEnd, begin);
+                cursors[kind].last = std::lower_bound(cursors[kind].next, streamEnd, end);
+            }
+        }
+
+        size_t index = begin;
+        while (true) {
+            if constexpr (consumes(EventKind::Any)) {
+                if (index >= end) {
+                    break;
+                }
+            }
+            else {
+                // The lowest index any consumed stream has next
+                index = end;
+                for (const Cursor& cursor : cursors) {
+                    if (cursor.next != cursor.last) {
+                        index = std::min<size_t>(index, *cursor.next);
+                    }
+                }
+                if (index >= end) {
+                    break;
+                }
+            }
+
+            uint32_t kinds = 0;
+            for (uint32_t kind = 0; kind < kStreamKinds; ++kind) {
+                Cursor& cursor = cursors[kind];
+                if (cursor.next != cursor.last && *cursor.next == index) {
+                    kinds |= 1u << kind;
+                    ++cursor.next;
+                }
+            }
+
+            if (token.poll()) {
+                return false;
+            }
+            dispatch(events[index], kinds);
+            ++index;
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint32_t kStreamKinds = static_cast<uint32_t>(EventKind::Any);
+    static constexpr uint32_t kConsumedKinds = (Analyzers::kEventKinds | ... | 0u);
+
+    static constexpr bool consumes(EventKind kind) {
+        return (kConsumedKinds & eventKindBit(kind)) != 0;
+    }
+
+    void dispatch(const CombatEvent& event, uint32_t kinds) {
+        dispatchKind<EventKind::Any>(event, kinds | eventKindBit(EventKind::Any));
+        dispatchKind<EventKind::StrikeDamage>(event, kinds);
+        dispatchKind<EventKind::CondiDamage>(event, kinds);
+        dispatchKind<EventKind::KillingBlow>(event, kinds);
+        dispatchKind<EventKind::Strip>(event, kinds);
+        dispatchKind<EventKind::StateChange>(event, kinds);
+        dispatchKind<EventKind::Activation>(event, kinds);
+    }
+
+    template <EventKind Kind>
+    void dispatchKind(const CombatEvent& event, uint32_t kinds) {
+        if constexpr (consumes(Kind)) {
+            if (kinds & eventKindBit(Kind)) {
+                std::apply([&](auto&... analyzer) { (visit<Kind>(analyzer, event), ...); }, analyzers);
+            }
+        }
+    }
+
+    template <EventKind Kind, typename Analyzer>
+    static void visit(Analyzer& analyzer, const CombatEvent& event) {
+        if constexpr ((Analyzer::kEventKinds & eventKindBit(Kind)) != 0) {
+            analyzer.onEvent(EventTag<Kind>{}, event);
+        }
+    }
+
+    std::tuple<Analyzers&...> analyzers;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -7,12 +8,49 @@
 #include <Windows.h>
 #include <mutex>
 #include <atomic>
+#include "parser/buffer_pool.h"
+#include "parser/cancellation.h"
+#include "parser/mapped_file.h"
+#include "parser/parse_metrics.h"
+#include "settings/Settings.h"
+#include "shared/Shared.h"
+
+// Raw EVTC bytes of one log: inflated into a pooled buffer for .zevtc, or
+// mapped straight from disk for .evtc. data/size stay valid while the
+// source is alive, including after it has been moved to another thread.
+struct EVTCSource {
+    LogSourceKind kind = LogSourceKind::Compressed;
+    BufferPool::Lease buffer;
+    MappedFile mapping;
+    const char* data = nullptr;
+    size_t size = 0;
+};
 
 
 // Function declarations
 void monitorDirectory(size_t numLogsToParse, size_t pollIntervalMilliseconds);
 std::vector<char> extractZipFile(const std::string& filePath);
-void processNewEVTCFile(const std::filesystem::path& filePath);
+// Both stop early once the token is cancelled; the result is then incomplete
+// and must be thrown away.
+bool loadEVTCFile(const std::filesystem::path& filePath, BufferPool& pool, EVTCSource& source,
+    const CancellationToken& token = {});
+// Background logs run the stats pass on the calling thread only, so backlog
+// parses never take more cores than there are parse workers.
+ParsedData parseEVTCSource(const EVTCSource& source, const ParserSettingsSnapshot& settings,
+    const CancellationToken& token = {}, bool background = false);
+
+// One thread count of the accumulation benchmark: the best of a few parses
+// of the same log, and whether its stats match the single-threaded run.
+struct AccumulationBenchmarkRun {
+    size_t threads = 0;
+    double milliseconds = 0.0;
+    bool matchesSequential = true;
+};
+
+// Times the stats pass over one log at 1 to 16 threads.
+// Blocking; returns nothing if the log cannot be read or the token is cancelled.
+std::vector<AccumulationBenchmarkRun> benchmarkAccumulation(const std::filesystem::path& filePath,
+    const ParserSettingsSnapshot& settings, const CancellationToken& token = {});
 
 
 // Extern declarations for global variables
@@ -5,6 +5,7 @@
 #include <unordered_set>
 #include "shared/Shared.h"
 #include "settings/Settings.h"
+#include "parser/cancellation.h"
 
 // UTF-8 conversion helpers
 std::string wideToUtf8(const std::wstring& wstr);
@@ -15,21 +16,27 @@ extern std::unordered_set<std::wstring> processedFiles;
 extern std::filesystem::file_time_type maxProcessedTime;
 
 // File operations
+bool extractZipFile(const std::filesystem::path& filePath, std::vector<char>& output,
+    const CancellationToken& token = {});
 std::vector<char> extractZipFile(const std::filesystem::path& filePath);
 std::vector<char> extractZipFile(const std::string& filePath);
 
-void waitForFile(const std::filesystem::path& filePath);
-void waitForFile(const std::string& filePath);
 std::wstring getCanonicalPath(const std::filesystem::path& path);
+bool isEVTCLogFile(const std::filesystem::path& filePath);
+bool isCompressedEVTCFile(const std::filesystem::path& filePath);
 std::filesystem::path getArcPath();
 int getBossEncounterNpcDirs();
 bool isValidEVTCFile(const std::filesystem::path& dirPath, const std::filesystem::path& filePath);
 
 // Directory monitoring
+class FileWatcher;
+struct FileWatchEvent;
+
 void monitorDirectory(size_t numLogsToParse, size_t pollIntervalMilliseconds);
-void scanForNewFiles(const std::filesystem::path& dirPath, std::unordered_set<std::wstring>& processedFiles);
+bool runMonitorLoop(FileWatcher& watcher, std::unordered_set<std::wstring>& processedFiles);
+void processWatchEvents(const std::vector<FileWatchEvent>& events, std::unordered_set<std::wstring>& processedFiles);
+void scanForNewFiles(std::unordered_set<std::wstring>& processedFiles);
 void parseInitialLogs(std::unordered_set<std::wstring>& processedFiles, size_t numLogsToParse);
 bool isRunningUnderWine();
 
-void processEVTCFile(const std::filesystem::path& filePath);
 ParsedData parseEVTCFile(const std::filesystem::path& filePath, const ParserSettingsSnapshot& settings);
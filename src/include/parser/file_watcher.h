@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+struct FileWatchEvent {
+    enum class Action : uint8_t {
+        Added,
+        Modified,
+        Removed,
+        RenamedTo
+    };
+
+    std::filesystem::path path;
+    Action action = Action::Added;
+};
+
+enum class FileWatchStatus {
+    Changes,        // events were filled with exact file names
+    Timeout,        // nothing happened within the timeout
+    RescanRequired, // something changed but the backend cannot say what
+    Failed          // the watch is broken and must be recreated
+};
+
+/**
+ * @brief Source of change notifications for the arcdps log tree.
+ *
+ * Backends report the exact files that changed where the OS allows it, so
+ * a new log is found without walking the whole directory tree. Anything
+ * that cannot be attributed to a file is reported as RescanRequired.
+ */
+class FileWatcher {
+public:
+    virtual ~FileWatcher() = default;
+
+    virtual bool start(const std::filesystem::path& dirPath) = 0;
+
+    // Blocks for at most timeout. Events are appended to the given vector.
+    virtual FileWatchStatus wait(std::chrono::milliseconds timeout, std::vector<FileWatchEvent>& events) = 0;
+
+    // May be called from any thread. Wakes a wait() in progress, and makes
+    // every later wait() return Timeout at once.
+    virtual void interrupt() = 0;
+
+    virtual const char* getName() const = 0;
+};
+
+// ReadDirectoryChangesW; null where there is no native backend.
+std::unique_ptr<FileWatcher> createNativeFileWatcher();
+
+// Periodic full rescans; used in Wine compatibility mode and as a fallback.
+std::unique_ptr<FileWatcher> createPollingFileWatcher(size_t pollIntervalMilliseconds);
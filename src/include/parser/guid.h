@@ -0,0 +1,85 @@
+#pragma once
+
+#include "shared/Shared.h"
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief A 128-bit GUID as arcdps writes it into combat events.
+ *
+ * The two halves hold the bytes in log order, so a GUID read from an event
+ * compares directly against one built from its hex form, with no formatting
+ * or allocation on the way.
+ */
+struct Guid128 {
+    uint64_t first8 = 0;
+    uint64_t last8 = 0;
+
+    constexpr bool operator==(const Guid128& other) const {
+        return first8 == other.first8 && last8 == other.last8;
+    }
+    constexpr bool operator!=(const Guid128& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief Builds a GUID from 32 hex digits, byte by byte in log order.
+     *
+     * Meant for constexpr tables; a malformed literal fails to compile there.
+     */
+    static constexpr Guid128 fromHex(const char (&hex)[33]) {
+        Guid128 guid;
+        for (int i = 0; i < 8; ++i) {
+            guid.first8 |= static_cast<uint64_t>(hexByte(hex[i * 2], hex[i * 2 + 1])) << (i * 8);
+            guid.last8 |= static_cast<uint64_t>(hexByte(hex[16 + i * 2], hex[16 + i * 2 + 1])) << (i * 8);
+        }
+        return guid;
+    }
+
+    // IDToGUID: the GUID is in src_agent and dst_agent.
+    static constexpr Guid128 fromIdToGuid(const CombatEvent& event) {
+        return Guid128{ event.srcAgent, event.dstAgent };
+    }
+
+    // Guild: the GUID runs from dst_agent through buff_dmg.
+    static Guid128 fromGuild(const CombatEvent& event) {
+        Guid128 guid;
+        guid.first8 = event.dstAgent;
+        std::memcpy(&guid.last8, &event.value, sizeof(guid.last8));
+        return guid;
+    }
+
+private:
+    static constexpr uint8_t hexDigit(char c) {
+        return c >= '0' && c <= '9' ? static_cast<uint8_t>(c - '0')
+            : c >= 'A' && c <= 'F' ? static_cast<uint8_t>(c - 'A' + 10)
+            : c >= 'a' && c <= 'f' ? static_cast<uint8_t>(c - 'a' + 10)
+            : throw "invalid hex digit in GUID";
+    }
+
+    static constexpr uint8_t hexByte(char high, char low) {
+        return static_cast<uint8_t>((hexDigit(high) << 4) | hexDigit(low));
+    }
+};
+
+// The GUIDs the game gives each WvW team color.
+struct TeamColorGuid {
+    Guid128 guid;
+    const char* color;
+};
+
+inline constexpr TeamColorGuid WVW_TEAM_COLOR_GUIDS[] = {
+    { Guid128::fromHex("BC8AEAEF73DC8C43B041CEDFEA4D5020"), "Green" },
+    { Guid128::fromHex("5D22513B9498EB48944E94EC7A8DD657"), "Red" },
+    { Guid128::fromHex("CF6F7C254FCB184CBCCE4738EADD8388"), "Blue" },
+};
+
+// Returns the team color the GUID names, or nullptr.
+constexpr const char* findTeamColor(const Guid128& guid) {
+    for (const auto& entry : WVW_TEAM_COLOR_GUIDS) {
+        if (entry.guid == guid) {
+            return entry.color;
+        }
+    }
+    return nullptr;
+}
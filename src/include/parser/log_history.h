@@ -0,0 +1,130 @@
+#pragma once
+
+#include "parser/packed_log.h"
+#include "settings/Settings.h"
+#include "shared/Shared.h"
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// The user's minimum thresholds for showing a log.
+struct LogFilters {
+    int minTotalPlayers = 0;
+    int minTotalDeaths = 0;
+    int minTotalDowns = 0;
+    int minCombatDuration = 0;
+
+    static LogFilters fromSettings(const ParserSettingsSnapshot& settings);
+};
+
+/**
+ * @brief What the filters and the aggregates need from one log.
+ *
+ * A few hundred bytes per log, so one can be kept for every WvW log seen in
+ * the session long after its full ParsedData has been dropped.
+ */
+struct LogSummary {
+    struct Squad {
+        uint32_t totalPlayers = 0;
+        uint32_t totalDeaths = 0;
+        uint32_t totalDowned = 0;
+        std::vector<std::pair<std::string, uint32_t>> specCounts;
+    };
+
+    struct Team {
+        uint32_t id = 0;
+        // Empty while nothing names the ID
+        std::string name;
+        bool isPOVTeam = false;
+        Squad totals;
+        Squad povSquad;
+    };
+
+    std::filesystem::file_time_type fileTime{};
+    uint64_t combatDuration = 0;
+    // Totals over the named teams, as the filters see them
+    uint32_t totalPlayers = 0;
+    uint32_t totalDeaths = 0;
+    uint32_t totalDowns = 0;
+    // Live logs count toward the session aggregates; backlog does not.
+    bool live = false;
+    std::vector<Team> teams;
+    std::unordered_map<uint32_t, std::string> logTeamNames;
+
+    static LogSummary fromParsedLog(const ParsedLog& log, bool live,
+        const std::unordered_map<int, std::string>& teamIDs);
+
+    size_t getMemoryUsage() const;
+
+    // Names each team from the log's own table or the user's team IDs and
+    // recomputes the totals.
+    void resolveTeams(const std::unordered_map<int, std::string>& teamIDs);
+};
+
+// Describes the first filter the log falls short of, or returns an empty
+// string if it passes them all.
+std::string getFilterMiss(const LogSummary& summary, const LogFilters& filters);
+
+/**
+ * @brief Every WvW log parsed this session, with the filters applied as a view.
+ *
+ * parsedLogs and the aggregates are rebuilt from here whenever a log is
+ * added or a threshold changes, so loosening a filter brings hidden logs
+ * back without reading anything from disk. Stats are kept per raw team ID,
+ * so naming a team ID relabels every kept log in place. The newest logs are
+ * kept packed and only the ones on show are unpacked; older live logs keep
+ * just their summary for the aggregates.
+ */
+class LogHistory {
+public:
+    // Returns true if the log passes the current filters.
+    bool add(const ParsedLog& log, bool live, const ParserSettingsSnapshot& settings);
+
+    // Re-applies the team IDs, filters and history size to everything kept.
+    void refresh(const ParserSettingsSnapshot& settings);
+
+    // Team IDs with players in a kept log that nothing names yet.
+    std::vector<uint32_t> getUnknownTeamIds();
+
+    struct MemoryUsage {
+        size_t packedLogs = 0;
+        size_t packedBytes = 0;
+        size_t sharedDetailLogs = 0;
+        size_t sharedDetailBytes = 0;
+        size_t summaries = 0;
+        size_t summaryBytes = 0;
+    };
+    MemoryUsage getMemoryUsage();
+
+    // Stops the live logs seen so far from counting toward the aggregates.
+    void resetAggregates();
+
+private:
+    struct Entry {
+        LogSummary summary;
+        std::optional<PackedLog> log;
+    };
+
+    void applyTeamIDs(const std::unordered_map<int, std::string>& newTeamIDs);
+    void trimDetails();
+    // Keeps the selected log selected if it is still shown, unless
+    // showNewest moves the selection to the newest log.
+    void publishView(const ParserSettingsSnapshot& settings, bool showNewest) const;
+    void publishAggregates(const LogFilters& filters) const;
+
+    std::mutex mutex;
+    // Newest first by file time
+    std::deque<Entry> entries;
+    // The team ID table entries are currently labeled with
+    std::unordered_map<int, std::string> teamIDs;
+    // The filters of the last add or refresh, which decide what is shown
+    LogFilters viewFilters;
+};
+
+extern LogHistory logHistory;
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <filesystem>
+
+enum class LogReadiness {
+    Ready,   // the writer is done and the file is structurally complete
+    Writing, // the writer still has the file open, or the zip is truncated
+    Unknown, // cannot be decided from the file alone; wait for the size to settle
+    Unreadable // the file cannot be opened for a reason waiting will not fix
+};
+
+/**
+ * @brief One-shot check whether arcdps has finished writing a log.
+ *
+ * On Windows the file is opened without write sharing, which fails with a
+ * sharing violation for as long as arcdps holds it open; any other open
+ * failure is reported as Unreadable rather than waited on. A .zevtc must also end in a zip central
+ * directory that points at a fully written entry. The entry CRC is checked
+ * by miniz when the log is inflated. A plain .evtc has no trailer, so
+ * without share modes it reports Unknown.
+ */
+LogReadiness checkLogReadiness(const std::filesystem::path& filePath);
+
+// Whether data ends in a zip end-of-central-directory record whose first
+// entry lies completely inside the buffer.
+bool hasCompleteZipDirectory(const char* data, size_t size);
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "shared/Shared.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A ParsedLog packed for keeping in the log history.
+ *
+ * Team and squad totals are sums of their spec rows, so only the spec rows
+ * are stored: a dense spec index, a mask of the counters that are non-zero
+ * and those counters as varints, all in one flat byte array. The squad's
+ * parties are rows of the same form keyed by party index, followed by
+ * each team's strips by skill as skill ID and count pairs. Teams stay
+ * keyed by raw team ID and are named again on unpack. A typical fight packs
+ * into two to three kilobytes. Each team's timeline keeps only its non-zero
+ * seconds, as varint gap and value pairs, in a separate buffer of around
+ * fifteen bytes per second of fight per team. That buffer, the range index,
+ * player table and skill table are the shared details, which can be
+ * dropped on their own once the log is no longer recent.
+ */
+class PackedLog {
+public:
+    static PackedLog pack(const ParsedLog& log);
+
+    // Rebuilds the full log, naming teams from the log's own table and teamIDs.
+    ParsedLog unpack(const std::unordered_map<int, std::string>& teamIDs) const;
+
+    // The packed bytes alone; the shared details are counted separately, as
+    // the shown logs share them too.
+    size_t getMemoryUsage() const;
+    size_t getSharedDetailsMemoryUsage() const;
+
+    void dropSharedDetails() {
+        timelines.reset();
+        rangeIndex.reset();
+        players.reset();
+        skills.reset();
+    }
+
+private:
+    struct Team {
+        uint32_t id = 0;
+        // The team counters that no spec row carries
+        uint32_t deathsFromKillingBlows = 0;
+        uint32_t squadDeathsFromKillingBlows = 0;
+        float timeWeightedPlayers = 0.0f;
+        float squadTimeWeightedPlayers = 0.0f;
+        uint16_t specRows = 0;
+        uint16_t squadSpecRows = 0;
+        uint8_t subgroupRows = 0;
+        uint8_t stripSkillRows = 0;
+        uint16_t timelineBuckets = 0;
+        bool isPOVTeam = false;
+    };
+
+    std::string filename;
+    std::filesystem::file_time_type fileTime{};
+    uint64_t combatStartTime = 0;
+    uint64_t combatEndTime = 0;
+    uint64_t logStartUnix = 0;
+    uint64_t logEndUnix = 0;
+    uint16_t fightId = 0;
+    std::vector<Team> teams;
+    std::vector<std::pair<uint32_t, std::string>> logTeamNames;
+    // Each team's spec rows, then its squad's, its squad's parties' and its
+    // strips by skill, in team order
+    std::vector<uint8_t> specRows;
+    // Each team's timeline series, in team order
+    std::shared_ptr<const std::vector<uint8_t>> timelines;
+    std::shared_ptr<const FightRangeIndex> rangeIndex;
+    std::shared_ptr<const PlayerStatsTable> players;
+    std::shared_ptr<const SkillStatsTable> skills;
+};
+
+// Rough heap and inline footprint of a full ParsedData. The range index,
+// player table and skill table are shared with the packed log and left out.
+size_t estimateMemoryUsage(const ParsedData& data);
+
+// Rough heap footprint of a fight range index.
+size_t estimateMemoryUsage(const FightRangeIndex& index);
+
+// Rough heap footprint of a player table.
+size_t estimateMemoryUsage(const PlayerStatsTable& table);
+
+// Rough heap footprint of a skill table; the names are in the process-wide
+// pool and not counted.
+size_t estimateMemoryUsage(const SkillStatsTable& table);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "parser/parse_scheduler.h"
+
+/**
+ * @brief Running latency figures for one step of log processing.
+ *
+ * Written by the parser threads and read by the options window, so every
+ * field is a relaxed atomic; the figures are informational only.
+ */
+struct LatencyStat {
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> totalMicros{ 0 };
+    std::atomic<uint64_t> maxMicros{ 0 };
+
+    void record(std::chrono::steady_clock::duration elapsed);
+    double getAverageMilliseconds() const;
+    double getMaxMilliseconds() const;
+    void reset();
+};
+
+enum class LogSourceKind : uint8_t {
+    Compressed = 0,   // .zevtc, inflated through miniz
+    Uncompressed = 1, // .evtc, parsed straight from a file mapping
+    Count
+};
+
+struct ParseMetrics {
+    // Time to get the raw EVTC bytes in memory (inflate or map)
+    LatencyStat load[static_cast<size_t>(LogSourceKind::Count)];
+    // Time from raw bytes to ParsedData
+    LatencyStat parse[static_cast<size_t>(LogSourceKind::Count)];
+    // Time in the stats pass (deaths, downs, damage, strips, kills), the largest part of a parse
+    LatencyStat accumulate;
+    // Time from the first change notification until the writer was done
+    LatencyStat readiness;
+    // Time from the first change notification until the log was shown
+    LatencyStat detectionToPublish;
+    // Time from a stop request until the monitor thread has exited
+    LatencyStat monitorShutdown;
+    // Time parse threads slept under the Throttle policy
+    LatencyStat combatThrottle;
+
+    // Frame times with no log being parsed, out of and in combat
+    LatencyStat idleFrames;
+    LatencyStat combatIdleFrames;
+    // Frame times while a log was being parsed out of combat
+    LatencyStat parsingFrames;
+    // Frame times while a log was being parsed in combat, per policy in force
+    LatencyStat combatParsingFrames[static_cast<size_t>(CombatParsePolicy::Count)];
+
+    void reset();
+};
+
+extern ParseMetrics parseMetrics;
+
+// Measures the lifetime of the object into the given stat.
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyStat& stat)
+        : stat(&stat), start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        if (stat) {
+            stat->record(std::chrono::steady_clock::now() - start);
+        }
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    // Leaves a failed or abandoned step out of the stat.
+    void dismiss() { stat = nullptr; }
+
+private:
+    LatencyStat* stat;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "parser/bounded_queue.h"
+#include "parser/buffer_pool.h"
+#include "parser/evtc_parser.h"
+#include "shared/Shared.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <vector>
+
+enum class LogPriority : uint8_t {
+    Live = 0,   // written by arcdps while the addon is running
+    Backlog = 1 // history parsed when monitoring starts
+};
+
+struct LogJob {
+    std::filesystem::path path;
+    std::filesystem::file_time_type lastWriteTime{};
+    // When the watcher first saw the log; unset for backlog.
+    std::chrono::steady_clock::time_point detectedAt{};
+    LogPriority priority = LogPriority::Live;
+};
+
+/**
+ * @brief Inflate, parse and publish stages for logs that are ready to read.
+ *
+ * Discovery and readiness run on the directory monitor thread, which hands
+ * finished logs to submit(). Inflate and parse each run on workerCount
+ * threads; publishing runs on one thread so parsedLogs and the aggregates
+ * see one log at a time. The stages are joined by bounded queues, so a burst
+ * of logs only keeps a few inflated buffers alive, and live logs overtake
+ * backlog at every stage. Every submitted job ends in exactly one call to
+ * finish, on whichever thread it stopped: after publishing, or after its
+ * load, parse or publish threw. Jobs dropped by cancel() are not finished.
+ */
+class ParsePipeline {
+public:
+    using PublishFn = std::function<void(const LogJob& job, ParsedLog&& log)>;
+    using FinishFn = std::function<void(const LogJob& job)>;
+
+    ParsePipeline(size_t workerCount, PublishFn publish, FinishFn finish = {});
+    ~ParsePipeline();
+
+    ParsePipeline(const ParsePipeline&) = delete;
+    ParsePipeline& operator=(const ParsePipeline&) = delete;
+
+    // Blocks while the job queue is full. Returns false once stopped.
+    bool submit(LogJob job);
+
+    // Safe from any thread and returns at once: drops queued work and makes
+    // the inflate and parse loops in flight bail out at their next check.
+    void cancel();
+
+    // Cancels, then waits for the stage threads to exit. Called from the
+    // thread that owns the pipeline.
+    void stop();
+
+    size_t getQueuedCount() const;
+    size_t getRetainedBufferBytes() const;
+
+private:
+    struct LoadedLog {
+        LogJob job;
+        EVTCSource source;
+    };
+
+    struct ParsedLogResult {
+        LogJob job;
+        ParsedLog log;
+    };
+
+    void runInflateStage();
+    void runParseStage();
+    void runPublishStage();
+    void finishJob(const LogJob& job);
+
+    PublishFn publish;
+    FinishFn finish;
+    BufferPool bufferPool;
+    BoundedQueue<LogJob> jobs;
+    BoundedQueue<LoadedLog> loadedLogs;
+    BoundedQueue<ParsedLogResult> parsedLogResults;
+    std::vector<std::thread> inflateThreads;
+    std::vector<std::thread> parseThreads;
+    std::thread publishThread;
+    std::atomic<bool> cancelled{ false };
+    bool stopped = false;
+};
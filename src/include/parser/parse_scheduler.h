@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+enum class CombatParsePolicy : uint8_t {
+    FullSpeed = 0,     // parse at normal priority whether in combat or not
+    LowerPriority = 1, // drop parse threads to the lowest priority in combat
+    Throttle = 2,      // lowest priority plus a cap on CPU time per slice in combat
+    Count
+};
+
+/**
+ * @brief Keeps log parsing out of the game's way while the player fights.
+ *
+ * Parse workers call pace() at every cancellation checkpoint. Out of combat
+ * it returns straight away; in combat it applies the configured policy to
+ * the calling thread, and normal priority comes back at the first checkpoint
+ * after combat ends. The policy may be changed from any thread.
+ *
+ * The render thread calls recordFrame() once per frame so the options
+ * window can compare frame times with and without parsing under each policy.
+ */
+class ParseScheduler {
+public:
+    void setPolicy(CombatParsePolicy policy);
+    CombatParsePolicy getPolicy() const;
+
+    void pace();
+    void recordFrame();
+
+    // Marks the calling worker as busy with a log for as long as it lives.
+    class BusyScope {
+    public:
+        explicit BusyScope(ParseScheduler& scheduler);
+        ~BusyScope();
+
+        BusyScope(const BusyScope&) = delete;
+        BusyScope& operator=(const BusyScope&) = delete;
+
+    private:
+        ParseScheduler& scheduler;
+    };
+
+private:
+    std::atomic<CombatParsePolicy> policy{ CombatParsePolicy::LowerPriority };
+    std::atomic<uint32_t> busyWorkers{ 0 };
+    // Render thread only
+    std::chrono::steady_clock::time_point lastFrame{};
+};
+
+extern ParseScheduler parseScheduler;
+
+// The calling thread's scheduling priority, for handing on to helper
+// threads it starts.
+int getCurrentThreadPriority();
+
+// Gives the calling helper thread the priority of the worker that started
+// it; pace() then raises or lowers it like the worker's own.
+void adoptThreadPriority(int priority);
+
+bool isPlayerInCombat();
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Every skill name the parsed logs have named, stored once per process.
+ *
+ * Each log repeats its skill table, but a player's logs share most of their
+ * skills, so names are interned here and logs keep only pool indices. A skill
+ * keeps the first name seen for its ID. Indices and names never change once
+ * handed out, so a name reference stays valid for the life of the process.
+ */
+class SkillNamePool {
+public:
+    // Returns the pool index of the skill, adding it if it is new
+    uint32_t intern(uint32_t skillId, std::string_view name);
+
+    const std::string& getName(uint32_t index) const;
+    uint32_t getSkillId(uint32_t index) const;
+    size_t size() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<uint32_t, uint32_t> indexBySkillId;
+    // A deque so names do not move as the pool grows
+    std::deque<std::string> names;
+    std::vector<uint32_t> skillIds;
+};
+
+extern SkillNamePool skillNamePool;
+
+// Skill IDs are well below this; it bounds the ID to dense index array
+constexpr uint32_t kMaxDenseSkillId = 1u << 18;
+
+/**
+ * @brief One log's skills by dense index, for per-skill counters in flat arrays.
+ *
+ * Dense indices follow the log's own skill table. Skill IDs map to them
+ * through a plain array, so the stats pass pays one load per event.
+ */
+struct LogSkillTable {
+    static constexpr uint16_t kNoSkill = UINT16_MAX;
+
+    // The pool index of each dense index's skill
+    std::vector<uint32_t> poolIndices;
+    // Dense index by skill ID, kNoSkill for IDs the table does not list
+    std::vector<uint16_t> denseIndexBySkillId;
+
+    uint16_t getDenseIndex(uint32_t skillId) const {
+        return skillId < denseIndexBySkillId.size() ? denseIndexBySkillId[skillId] : kNoSkill;
+    }
+
+    size_t size() const { return poolIndices.size(); }
+};
+
+/**
+ * @brief Decode a log's skill table and intern its names
+ * @param data The skill table: skillCount entries of a 4-byte ID and a 64-byte name
+ * @param skillCount The number of entries
+ * @param pool The pool to intern the names into
+ * @return The log's skill table; skills with IDs of kMaxDenseSkillId or more
+ * are left out, as are entries past the first 65535
+ */
+LogSkillTable parseSkillTable(const char* data, uint32_t skillCount, SkillNamePool& pool);
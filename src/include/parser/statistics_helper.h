@@ -1,6 +1,7 @@
 #pragma once
 
 #include "evtc_parser.h"
+#include "parser/skill_table.h"
 #include "shared/Shared.h"
 #include <algorithm> 
 #include <cstdint>
@@ -15,22 +16,149 @@
  */
 bool isTrackedBoon(uint32_t skillId);
 
+enum class StatEvent : uint8_t {
+    StrikeDamage,
+    CondiDamage,
+    Kill,
+    Strip
+};
+
+/**
+ * @brief The counter blocks one agent's events add into
+ *
+ * Resolved once per agent rather than per event, so an event costs no map
+ * lookups. squad and squadSpec are null unless the agent is in the POV squad,
+ * and subgroup also unless its party number is 1 to kMaxSubgroups.
+ */
+struct StatBlocks {
+    TeamStats* team = nullptr;
+    SpecStats* spec = nullptr;
+    SquadStats* squad = nullptr;
+    SpecStats* squadSpec = nullptr;
+    SpecStats* subgroup = nullptr;
+};
+
+/**
+ * @brief Find the counter blocks an agent's events add into
+ * @param teamStats The agent's team statistics
+ * @param agent The agent
+ * @return The team, spec and, for the POV squad, squad blocks
+ */
+StatBlocks resolveStatBlocks(TeamStats& teamStats, const Agent& agent);
+
+/**
+ * @brief Add one event into a team, squad or spec counter block
+ * @param stats The counter block; TeamStats, SquadStats, SpecStats and SpecCounters share the field names
+ * @param value Damage dealt, unused for kills and strips; of the block's counter width
+ * @param isDownedContribution Whether the damage went into a player that was then downed
+ * @param isKillContribution Whether the damage went into a player that was then killed
+ */
+template <StatEvent Kind, bool VsPlayer, typename Stats, typename Value>
+inline void addStatEvent(Stats& stats, Value value, bool isDownedContribution, bool isKillContribution) {
+    if constexpr (Kind == StatEvent::StrikeDamage || Kind == StatEvent::CondiDamage) {
+        constexpr bool isStrike = Kind == StatEvent::StrikeDamage;
+        stats.totalDamage += value;
+        (isStrike ? stats.totalStrikeDamage : stats.totalCondiDamage) += value;
+        if constexpr (VsPlayer) {
+            stats.totalDamageVsPlayers += value;
+            (isStrike ? stats.totalStrikeDamageVsPlayers : stats.totalCondiDamageVsPlayers) += value;
+        }
+
+        if (isDownedContribution) {
+            stats.totalDownedContribution += value;
+            if constexpr (VsPlayer) {
+                stats.totalDownedContributionVsPlayers += value;
+            }
+        }
+        if (isKillContribution) {
+            stats.totalKillContribution += value;
+            if constexpr (VsPlayer) {
+                stats.totalKillContributionVsPlayers += value;
+            }
+        }
+    }
+    else if constexpr (Kind == StatEvent::Kill) {
+        stats.totalKills++;
+        if constexpr (VsPlayer) {
+            stats.totalKillsVsPlayers++;
+        }
+    }
+    else {
+        stats.totalStrips++;
+        if constexpr (VsPlayer) {
+            stats.totalStripsVsPlayers++;
+        }
+    }
+}
+
+/**
+ * @brief Add one event into every block of an agent
+ *
+ * Specialized on the event kind, on whether the other side was a player and
+ * on POV squad membership, so the only branches left are the contribution
+ * flags of damage events.
+ */
+template <StatEvent Kind, bool VsPlayer, bool InSquad>
+inline void accumulateStatEvent(const StatBlocks& blocks, uint64_t value,
+    bool isDownedContribution, bool isKillContribution) {
+    addStatEvent<Kind, VsPlayer>(*blocks.team, value, isDownedContribution, isKillContribution);
+    addStatEvent<Kind, VsPlayer>(*blocks.spec, value, isDownedContribution, isKillContribution);
+    if constexpr (InSquad) {
+        addStatEvent<Kind, VsPlayer>(*blocks.squad, value, isDownedContribution, isKillContribution);
+        addStatEvent<Kind, VsPlayer>(*blocks.squadSpec, value, isDownedContribution, isKillContribution);
+        if (blocks.subgroup) {
+            addStatEvent<Kind, VsPlayer>(*blocks.subgroup, value, isDownedContribution, isKillContribution);
+        }
+    }
+}
+
 /**
- * @brief Update team statistics based on combat events
- * @param teamStats The team statistics to update
- * @param agent The agent involved in the event
- * @param value The value to update (damage amount, etc.)
- * @param isDamage Whether this update involves damage
- * @param isKill Whether this update involves a kill
- * @param vsPlayer Whether this update is against a player
- * @param isStrikeDamage Whether this update involves strike damage
- * @param isCondiDamage Whether this update involves condition damage
- * @param isDownedContribution Whether this update contributes to downing
- * @param isKillContribution Whether this update contributes to killing
- * @param isStrip Whether this update involves a boon strip
+ * @brief Pick the accumulateStatEvent specialization for one event
+ * @param blocks The acting agent's counter blocks
+ * @param value Damage dealt, unused for kills and strips
+ * @param vsPlayer Whether the other side of the event was a player
+ * @param isDownedContribution Whether the damage contributes to downing
+ * @param isKillContribution Whether the damage contributes to killing
  */
-void updateStats(TeamStats& teamStats, Agent* agent, int32_t value, bool isDamage, bool isKill, bool vsPlayer,
-    bool isStrikeDamage, bool isCondiDamage, bool isDownedContribution, bool isKillContribution, bool isStrip);
+template <StatEvent Kind>
+inline void recordStatEvent(const StatBlocks& blocks, uint64_t value, bool vsPlayer,
+    bool isDownedContribution = false, bool isKillContribution = false) {
+    if (blocks.squad) {
+        vsPlayer
+            ? accumulateStatEvent<Kind, true, true>(blocks, value, isDownedContribution, isKillContribution)
+            : accumulateStatEvent<Kind, false, true>(blocks, value, isDownedContribution, isKillContribution);
+    }
+    else {
+        vsPlayer
+            ? accumulateStatEvent<Kind, true, false>(blocks, value, isDownedContribution, isKillContribution)
+            : accumulateStatEvent<Kind, false, false>(blocks, value, isDownedContribution, isKillContribution);
+    }
+}
+
+/**
+ * @brief Add a spec row's counters into team or squad totals
+ * @param totals The team or squad statistics
+ * @param spec The spec row; its player count is not added
+ */
+template <typename Stats>
+inline void addSpecCounters(Stats& totals, const SpecStats& spec) {
+    totals.totalKills += spec.totalKills;
+    totals.totalKillsVsPlayers += spec.totalKillsVsPlayers;
+    totals.totalDeaths += spec.totalDeaths;
+    totals.totalDowned += spec.totalDowned;
+    totals.totalDamage += spec.totalDamage;
+    totals.totalStrips += spec.totalStrips;
+    totals.totalStripsVsPlayers += spec.totalStripsVsPlayers;
+    totals.totalStrikeDamage += spec.totalStrikeDamage;
+    totals.totalCondiDamage += spec.totalCondiDamage;
+    totals.totalDamageVsPlayers += spec.totalDamageVsPlayers;
+    totals.totalStrikeDamageVsPlayers += spec.totalStrikeDamageVsPlayers;
+    totals.totalCondiDamageVsPlayers += spec.totalCondiDamageVsPlayers;
+    totals.totalDownedContribution += spec.totalDownedContribution;
+    totals.totalDownedContributionVsPlayers += spec.totalDownedContributionVsPlayers;
+    totals.totalKillContribution += spec.totalKillContribution;
+    totals.totalKillContributionVsPlayers += spec.totalKillContributionVsPlayers;
+}
 
 /**
  * @brief Check if damage occurred as part of a sequence leading to a down
@@ -48,4 +176,140 @@ bool isDamageInDownSequence(const Agent* agent, const AgentState& state, uint64_
  * @param currentTime The current combat time
  * @return True if the damage contributes to a kill sequence
  */
-bool isDamageInKillSequence(const Agent* agent, const AgentState& state, uint64_t currentTime);
\ No newline at end of file
+bool isDamageInKillSequence(const Agent* agent, const AgentState& state, uint64_t currentTime);
+/**
+ * @brief Look up the display name of a raw team ID
+ * @param teamId The team ID from a TeamChange event
+ * @param logTeamNames Team colors the log names through its IDToGUID events
+ * @param teamIDs The user's team ID table from settings
+ * @return The team name, or an empty string if the ID is unknown
+ */
+std::string resolveTeamName(uint32_t teamId, const std::unordered_map<uint32_t, std::string>& logTeamNames,
+    const std::unordered_map<int, std::string>& teamIDs);
+
+/**
+ * @brief Add one team's statistics into another's
+ * @param into The statistics to add to
+ * @param from The statistics to add
+ */
+void mergeTeamStats(TeamStats& into, const TeamStats& from);
+
+/**
+ * @brief Check that two sets of per-team-ID statistics hold the same counters
+ * @param a The first set
+ * @param b The second set
+ * @return True if every team, squad and spec counter, every timeline bucket and every
+ * per-skill strip count matches
+ */
+bool sameTeamStats(const std::unordered_map<uint32_t, TeamStats>& a,
+    const std::unordered_map<uint32_t, TeamStats>& b);
+
+/**
+ * @brief Add one set of player counters into another with the same rows
+ * @param into The counters to add to
+ * @param from The counters to add
+ */
+void mergePlayerCounters(PlayerCounters& into, const PlayerCounters& from);
+
+/**
+ * @brief Find the players with the highest value of one counter
+ * @param table The log's player table
+ * @param stat The counter to rank by
+ * @param count How many players to return at most
+ * @param filter Takes a row and returns whether that player is a candidate
+ * @param total If set, receives the sum of the counter over every candidate
+ * @return Candidate rows with a non-zero value, highest first
+ *
+ * Only the top count candidates are ordered, so a leaderboard of a few rows
+ * costs about one pass over the column, however many players the log has.
+ */
+template <typename Filter>
+std::vector<uint32_t> selectTopPlayers(const PlayerStatsTable& table, PlayerStat stat, size_t count,
+    Filter&& filter, uint64_t* total = nullptr) {
+    const std::vector<uint64_t>& values = table.counters.column(stat);
+    std::vector<uint32_t> rows;
+    uint64_t sum = 0;
+    for (uint32_t row = 0; row < values.size(); ++row) {
+        if (values[row] != 0 && filter(row)) {
+            rows.push_back(row);
+            sum += values[row];
+        }
+    }
+    if (total) {
+        *total = sum;
+    }
+
+    count = std::min(count, rows.size());
+    std::partial_sort(rows.begin(), rows.begin() + count, rows.end(),
+        [&values](uint32_t a, uint32_t b) {
+            return values[a] != values[b] ? values[a] > values[b] : a < b;
+        });
+    rows.resize(count);
+    return rows;
+}
+
+/**
+ * @brief Add one set of per-skill counters into another of the same shape
+ * @param into The counters to add to
+ * @param from The counters to add
+ */
+void mergeSkillCounters(SkillCounters& into, const SkillCounters& from);
+
+/**
+ * @brief Keep the skills each group used, as pool indices, highest damage first
+ * @param counters The counters the stats pass filled
+ * @param skills The log's skill table the counters' columns follow
+ * @param table The groups from assignSkillGroups(), whose skill lists are filled
+ */
+void finishSkillStats(const SkillCounters& counters, const LogSkillTable& skills, SkillStatsTable& table);
+
+/**
+ * @brief Sum the per-skill totals of one spec of a team
+ * @param table The log's skill table
+ * @param teamIDs The raw team IDs shown under the team's name
+ * @param eliteSpec The spec
+ * @param squadOnly Whether to sum only the POV squad's groups
+ * @param vsPlayers Whether to rank by damage against players
+ * @param count How many skills to return at most
+ * @return The skills with the most damage, then strips, highest first
+ */
+std::vector<SkillTotals> sumSpecSkills(const SkillStatsTable& table, const std::vector<uint32_t>& teamIDs,
+    const std::string& eliteSpec, bool squadOnly, bool vsPlayers, size_t count);
+
+/**
+ * @brief Add one fight range index's per-bucket deltas into another's
+ * @param into The index to add to, with the same bucket count
+ * @param from The index to add
+ */
+void mergeRangeIndex(FightRangeIndex& into, const FightRangeIndex& from);
+
+/**
+ * @brief Turn an index of per-bucket deltas into running totals
+ * @param index The index the stats pass filled, with each bucket's delta in the row after it
+ */
+void finishRangeIndex(FightRangeIndex& index);
+
+/**
+ * @brief Restrict a log's team statistics to part of the fight
+ * @param data The whole log, with its rangeIndex
+ * @param firstBucket The first bucket of the range
+ * @param endBucket One past the last bucket of the range
+ * @param teamIDs The user's team ID table from settings
+ * @return A copy whose team, squad and spec counters cover only the range;
+ * player counts, timelines, party stats, strips by skill and the player and
+ * skill tables stay whole-fight
+ *
+ * Costs one subtraction per spec counter, so it can run every frame.
+ */
+ParsedData sliceParsedData(const ParsedData& data, size_t firstBucket, size_t endBucket,
+    const std::unordered_map<int, std::string>& teamIDs);
+
+/**
+ * @brief Rebuild the name-keyed team statistics from the per-team-ID ones
+ * @param data The parsed log to relabel
+ * @param teamIDs The user's team ID table from settings
+ *
+ * IDs that resolve to the same name are merged and unknown IDs are left out,
+ * so totalIdentifiedPlayers only counts players on a named team.
+ */
+void resolveTeamStats(ParsedData& data, const std::unordered_map<int, std::string>& teamIDs);
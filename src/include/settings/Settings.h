@@ -77,6 +77,7 @@ protected:
 struct MainWindowSettings : public BaseWindowSettings {
     // Basic display settings
     bool showLogName = true;
+    bool showTimeRange = false;
     bool useShortClassNames = false;
     bool showSpecBars = true;
     bool showSpecTooltips = true;
@@ -98,6 +99,10 @@ struct MainWindowSettings : public BaseWindowSettings {
     bool showTeamStrikeDamage = false;
     bool showTeamCondiDamage = false;
     bool showTeamStrips = false;
+    bool showTeamTimeline = false;
+    bool showTopPlayers = false;
+    int topPlayersCount = 5;
+    bool showSubgroups = false;
 
     // Style
     int barCornerRounding = 0;
@@ -201,6 +206,8 @@ struct ParserSettingsSnapshot {
     bool showNewParseAlert = true;
     bool forceLinuxCompatibilityMode = false;
     size_t pollIntervalMilliseconds = 3000;
+    size_t parserWorkerCount = 2;
+    int combatParsePolicy = 1;
     bool debugStringsMode = false;
     std::unordered_map<int, std::string> teamIDs;
 };
@@ -211,6 +218,8 @@ extern const char* TEAM_PLAYER_THRESHOLD;
 extern const char* SHOW_NEW_PARSE_ALERT;
 extern const char* FORCE_LINUX_COMPAT;
 extern const char* POLL_INTERVAL_MILLISECONDS;
+extern const char* PARSER_WORKER_COUNT;
+extern const char* COMBAT_PARSE_POLICY;
 extern const char* USE_NEXUS_ESC_CLOSE;
 extern const char* DEBUG_STRINGS_MODE;
 extern const char* TEAM_IDS;
@@ -235,6 +244,8 @@ namespace Settings {
     extern bool showNewParseAlert;
     extern bool forceLinuxCompatibilityMode;
     extern size_t pollIntervalMilliseconds;
+    extern size_t parserWorkerCount;
+    extern int combatParsePolicy;
     extern bool useNexusEscClose;
     extern bool debugStringsMode;
     extern int scrapperIconStyle;
@@ -1,6 +1,9 @@
 #pragma once
 #include <Windows.h>
+#include <array>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -134,6 +137,8 @@ struct Agent {
     std::string eliteSpec;
     std::string team = "Unknown";
     uint32_t teamID = 0;
+    // Row in the log's PlayerStatsTable; every agent on a team has one
+    uint32_t playerRow = UINT32_MAX;
 };
 
 struct SpecStats {
@@ -156,6 +161,9 @@ struct SpecStats {
     uint64_t totalKillContributionVsPlayers = 0;
 };
 
+// Parties of a squad, numbered from 1
+constexpr size_t kMaxSubgroups = 15;
+
 struct SquadStats {
     uint32_t totalPlayers = 0;
     uint32_t totalDeaths = 0;
@@ -175,6 +183,8 @@ struct SquadStats {
     uint64_t totalDownedContributionVsPlayers = 0;
     uint64_t totalKillContribution = 0;
     uint64_t totalKillContributionVsPlayers = 0;
+    // Players present on average over the combat time
+    float timeWeightedPlayers = 0.0f;
     float getKillDeathRatio() const {
         if (totalDeathsFromKillingBlows == 0) {
             return static_cast<float>(totalKills);
@@ -182,6 +192,62 @@ struct SquadStats {
         return static_cast<float>(totalKills) / totalDeathsFromKillingBlows;
     }
     std::unordered_map<std::string, SpecStats> eliteSpecStats;
+    // Each party's players and counters; party n is subgroupStats[n - 1]
+    std::array<SpecStats, kMaxSubgroups> subgroupStats{};
+};
+
+/**
+ * @brief One team's fight second by second, for graphing how it swung.
+ *
+ * Bucket 0 starts at combatStartTime. The series are either all empty (the
+ * team did nothing timed) or all getBucketCount() long, about 16 bytes per
+ * second of fight.
+ */
+struct TeamTimeline {
+    static constexpr uint64_t kBucketMs = 1000;
+    // Anything past four hours lands in the last bucket.
+    static constexpr size_t kMaxBuckets = 4 * 60 * 60;
+
+    // Outgoing damage, all and against logged players
+    std::vector<uint32_t> damage;
+    std::vector<uint32_t> damageVsPlayers;
+    // Downs, deaths and strips of the team's own players
+    std::vector<uint16_t> downs;
+    std::vector<uint16_t> deaths;
+    std::vector<uint16_t> strips;
+    // Players present at some point during each second
+    std::vector<uint16_t> players;
+
+    static size_t getBucketCount(uint64_t combatStartTime, uint64_t combatEndTime) {
+        uint64_t duration = combatEndTime > combatStartTime ? combatEndTime - combatStartTime : 0;
+        uint64_t buckets = duration / kBucketMs + 1;
+        return buckets < kMaxBuckets ? static_cast<size_t>(buckets) : kMaxBuckets;
+    }
+
+    static size_t getBucket(uint64_t time, uint64_t combatStartTime, size_t bucketCount) {
+        uint64_t bucket = time > combatStartTime ? (time - combatStartTime) / kBucketMs : 0;
+        return bucket < bucketCount ? static_cast<size_t>(bucket) : bucketCount - 1;
+    }
+
+    bool empty() const { return damage.empty(); }
+    size_t size() const { return damage.size(); }
+
+    void resize(size_t bucketCount) {
+        damage.resize(bucketCount);
+        damageVsPlayers.resize(bucketCount);
+        downs.resize(bucketCount);
+        deaths.resize(bucketCount);
+        strips.resize(bucketCount);
+        players.resize(bucketCount);
+    }
+
+    uint16_t getPeakPlayers() const {
+        uint16_t peak = 0;
+        for (uint16_t count : players) {
+            peak = count > peak ? count : peak;
+        }
+        return peak;
+    }
 };
 
 struct TeamStats {
@@ -203,6 +269,8 @@ struct TeamStats {
     uint64_t totalDownedContributionVsPlayers = 0;
     uint64_t totalKillContribution = 0;
     uint64_t totalKillContributionVsPlayers = 0;
+    // Players present on average over the combat time
+    float timeWeightedPlayers = 0.0f;
     bool isPOVTeam = false;
     float getKillDeathRatio() const {
         if (totalDeathsFromKillingBlows == 0) {
@@ -212,10 +280,192 @@ struct TeamStats {
     }
     std::unordered_map<std::string, SpecStats> eliteSpecStats;
     SquadStats squadStats;
+    TeamTimeline timeline;
+    // Counted strips by the boon strip skill the stripper had just cast,
+    // or 0 if it had cast none
+    std::unordered_map<uint32_t, uint32_t> stripsBySkill;
 };
 
+/**
+ * @brief The counters of SpecStats that change during a fight, at 32 bits.
+ *
+ * Used as running totals. They wrap past 2^32, but unsigned subtraction still
+ * gives the exact sum of any range holding less than that. Field names match
+ * SpecStats so the stat kernels fill both.
+ */
+struct SpecCounters {
+    uint32_t totalKills = 0;
+    uint32_t totalKillsVsPlayers = 0;
+    uint32_t totalDeaths = 0;
+    uint32_t totalDowned = 0;
+    uint32_t totalDamage = 0;
+    uint32_t totalStrips = 0;
+    uint32_t totalStripsVsPlayers = 0;
+    uint32_t totalStrikeDamage = 0;
+    uint32_t totalCondiDamage = 0;
+    uint32_t totalDamageVsPlayers = 0;
+    uint32_t totalStrikeDamageVsPlayers = 0;
+    uint32_t totalCondiDamageVsPlayers = 0;
+    uint32_t totalDownedContribution = 0;
+    uint32_t totalDownedContributionVsPlayers = 0;
+    uint32_t totalKillContribution = 0;
+    uint32_t totalKillContributionVsPlayers = 0;
+};
+
+/**
+ * @brief Running totals of every spec counter through a fight, so any part
+ * of it can be shown without a re-parse.
+ *
+ * Row i of a series holds the totals of buckets [0, i), so row 0 is all
+ * zero and a range of buckets is two rows subtracted per spec. Team totals
+ * are sums of their spec rows, as in SpecStats. Only specs that took part
+ * get a series. Buckets are 5 s until a fight runs past kMaxBuckets of
+ * them, then widen in 5 s steps, so a series is at most about 4 KB
+ * (61 rows of 64 bytes). A big three-team fight with a hundred or so
+ * spec series, the POV squad's included, comes to roughly 400 KB however
+ * long it ran.
+ */
+struct FightRangeIndex {
+    static constexpr uint64_t kMinBucketMs = 5000;
+    static constexpr size_t kMaxBuckets = 60;
+
+    struct Squad {
+        std::unordered_map<std::string, std::vector<SpecCounters>> specs;
+        // The one counter no spec row carries
+        std::vector<uint32_t> deathsFromKillingBlows;
+    };
+
+    struct Team {
+        Squad totals;
+        Squad povSquad;
+    };
+
+    uint64_t combatStartTime = 0;
+    uint64_t bucketMs = kMinBucketMs;
+    size_t bucketCount = 0;
+    std::unordered_map<uint32_t, Team> teams;
+
+    // Sizes the buckets so the fight fits in kMaxBuckets of them.
+    void setCombatRange(uint64_t startTime, uint64_t endTime) {
+        uint64_t duration = endTime > startTime ? endTime - startTime : 0;
+        uint64_t steps = duration / (kMinBucketMs * kMaxBuckets) + 1;
+        combatStartTime = startTime;
+        bucketMs = steps * kMinBucketMs;
+        uint64_t buckets = duration / bucketMs + 1;
+        bucketCount = buckets < kMaxBuckets ? static_cast<size_t>(buckets) : kMaxBuckets;
+    }
+
+    size_t getBucket(uint64_t time) const {
+        uint64_t bucket = time > combatStartTime ? (time - combatStartTime) / bucketMs : 0;
+        return bucket < bucketCount ? static_cast<size_t>(bucket) : bucketCount - 1;
+    }
+};
+
+// The counters kept for each player. Contributions only ever count damage
+// into players, so they have no separate vs players column.
+enum class PlayerStat : uint8_t {
+    Damage,
+    DamageVsPlayers,
+    Strips,
+    StripsVsPlayers,
+    DownedContribution,
+    KillContribution,
+    Kills,
+    Downs,
+    Deaths,
+    Count
+};
+
+/**
+ * @brief One column per PlayerStat, indexed by player row.
+ */
+struct PlayerCounters {
+    std::array<std::vector<uint64_t>, static_cast<size_t>(PlayerStat::Count)> columns;
+
+    std::vector<uint64_t>& column(PlayerStat stat) { return columns[static_cast<size_t>(stat)]; }
+    const std::vector<uint64_t>& column(PlayerStat stat) const { return columns[static_cast<size_t>(stat)]; }
+
+    void resize(size_t rowCount) {
+        for (auto& column : columns) {
+            column.resize(rowCount);
+        }
+    }
+};
+
+/**
+ * @brief Every team agent's own counters, for seeing who did what within a spec.
+ *
+ * Column by column rather than row by row, so ranking by one counter reads
+ * only that column. Rows are in team ID then address order; Agent::playerRow
+ * points back into it during the parse.
+ */
+struct PlayerStatsTable {
+    // Character name, else account name
+    std::vector<std::string> names;
+    std::vector<std::string> eliteSpecs;
+    std::vector<uint32_t> teamIDs;
+    // Non-zero for members of the POV squad
+    std::vector<uint8_t> inSquad;
+    PlayerCounters counters;
+
+    size_t size() const { return names.size(); }
+};
+
+/**
+ * @brief Per-skill counters of every skill group, in flat row-major arrays.
+ *
+ * The cell of a group and skill is group * skillCount + skill, where skill
+ * is the log's dense skill index. Sized before the stats pass, so adding an
+ * event is a load and an add.
+ */
+struct SkillCounters {
+    size_t groupCount = 0;
+    size_t skillCount = 0;
+    std::vector<uint64_t> damage;
+    std::vector<uint64_t> damageVsPlayers;
+    std::vector<uint32_t> strips;
+
+    void resize(size_t groups, size_t skills) {
+        groupCount = groups;
+        skillCount = skills;
+        damage.resize(groups * skills);
+        damageVsPlayers.resize(groups * skills);
+        strips.resize(groups * skills);
+    }
+};
+
+struct SkillTotals {
+    // Index into the process-wide skill name pool
+    uint32_t skill = 0;
+    uint64_t damage = 0;
+    uint64_t damageVsPlayers = 0;
+    // Strips attributed to the skill as a boon strip skill
+    uint32_t strips = 0;
+};
+
+/**
+ * @brief Each team's damage and strips by skill, split by spec and POV squad membership.
+ *
+ * A group holds the players of one team ID and spec, in or out of the POV
+ * squad, and only the skills it used, highest damage first. Skill names are
+ * in the process-wide pool, so a log holds none of its own.
+ */
+struct SkillStatsTable {
+    struct Group {
+        uint32_t teamID = 0;
+        std::string eliteSpec;
+        bool inSquad = false;
+        std::vector<SkillTotals> skills;
+    };
+    std::vector<Group> groups;
+};
 
 struct ParsedData {
+    // Stats per raw team ID, as parsed. teamStats is resolved from these by
+    // name with resolveTeamStats(), so relabeling needs no re-parse.
+    std::unordered_map<uint32_t, TeamStats> teamStatsById;
+    // Team colors named by the log's own IDToGUID events
+    std::unordered_map<uint32_t, std::string> logTeamNames;
     std::unordered_map<std::string, TeamStats> teamStats;
     uint64_t combatStartTime = 0;
     uint64_t combatEndTime = 0;
@@ -223,6 +473,14 @@ struct ParsedData {
     uint64_t logEndUnix = 0;
     uint16_t fightId = 0;
     size_t totalIdentifiedPlayers = 0;
+    // Set by the parser; shared by every copy of the log and dropped once
+    // the log leaves the recent history
+    std::shared_ptr<const FightRangeIndex> rangeIndex;
+    // Set by the parser and shared like rangeIndex; whole-fight even when
+    // the view is sliced to a time range
+    std::shared_ptr<const PlayerStatsTable> players;
+    // Set by the parser and shared like players
+    std::shared_ptr<const SkillStatsTable> skills;
 
     double getCombatDurationSeconds() const {
         if (combatEndTime > combatStartTime) {
@@ -250,6 +508,8 @@ struct LogParsedEventArgs {
 
 struct ParsedLog {
     std::string filename;
+    // Write time of the log file; parsedLogs is kept newest first by it.
+    std::filesystem::file_time_type fileTime{};
     ParsedData data;
 };
 
@@ -360,12 +620,40 @@ struct CombatEvent {
 };
 #pragma pack(pop)
 
+// Read-only view over the event block of an EVTC buffer. Events are read in
+// place from the inflated buffer or file mapping; CombatEvent is packed, so
+// the unaligned start offset is fine.
+struct CombatEventView {
+    const CombatEvent* events = nullptr;
+    size_t count = 0;
+
+    const CombatEvent* begin() const { return events; }
+    const CombatEvent* end() const { return events + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const CombatEvent& operator[](size_t index) const { return events[index]; }
+};
+
+enum class AgentStateKind : uint8_t {
+    Down = 0,
+    Up = 1,
+    Dead = 2,
+    Health = 3
+};
+
+// One down, up, death or health update of a player: the 16 bytes the
+// contribution checks need rather than the whole 64-byte CombatEvent.
+struct AgentStateRecord {
+    uint64_t time = 0;
+    uint16_t healthPermille = 0; // Health records only
+    AgentStateKind kind = AgentStateKind::Health;
+};
+static_assert(sizeof(AgentStateRecord) == 16, "AgentStateRecord should stay 16 bytes");
+
 struct AgentState {
     std::vector<std::pair<uint64_t, uint64_t>> downIntervals;
-    std::vector<std::pair<uint64_t, uint64_t>> deathIntervals;
-    std::vector<std::pair<uint64_t, float>> healthUpdates;
-    std::vector<CombatEvent> relevantEvents;
-    bool currentlyDowned = false;
+    // Ordered by time
+    std::vector<AgentStateRecord> records;
 };
 
 // enum
@@ -401,6 +689,7 @@ enum class StateChange : uint8_t {
     StackActive = 26,
     StackReset = 27,
     Guild = 28,
+    IdToGuid = 46,
     Error = 0xFF
 };
 
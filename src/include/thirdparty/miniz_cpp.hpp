@@ -46,6 +46,12 @@ public:
     }
 
     bool load(const std::filesystem::path& path) {
+        return load(path, buffer_);
+    }
+
+    // Reads the archive into caller-owned storage so its allocation can be
+    // reused across archives. The storage must outlive the open archive.
+    bool load(const std::filesystem::path& path, std::vector<char>& storage) {
         close();
 
         std::ifstream input(path, std::ios::binary | std::ios::ate);
@@ -58,16 +64,32 @@ public:
             return false;
         }
 
-        buffer_.resize(static_cast<size_t>(fileSize));
+        storage.resize(static_cast<size_t>(fileSize));
         input.seekg(0, std::ios::beg);
-        if (!input.read(reinterpret_cast<char*>(buffer_.data()), buffer_.size())) {
-            buffer_.clear();
+        if (!input.read(storage.data(), storage.size())) {
+            return false;
+        }
+
+        std::memset(&archive_, 0, sizeof(archive_));
+        if (!mz_zip_reader_init_mem(&archive_, storage.data(), storage.size(), 0)) {
+            archive_.m_pState = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Opens an archive that already sits in memory (e.g. a file mapping)
+    // without copying it. The memory must outlive the open archive.
+    bool load(const void* data, size_t size) {
+        close();
+
+        if (!data || size == 0) {
             return false;
         }
 
         std::memset(&archive_, 0, sizeof(archive_));
-        if (!mz_zip_reader_init_mem(&archive_, buffer_.data(), buffer_.size(), 0)) {
-            buffer_.clear();
+        if (!mz_zip_reader_init_mem(&archive_, data, size, 0)) {
             archive_.m_pState = nullptr;
             return false;
         }
@@ -109,9 +131,62 @@ public:
         return result;
     }
 
+    // Inflates into caller-owned output, reusing its existing capacity.
+    void read(mz_uint index, std::vector<char>& output) const {
+        mz_zip_archive_file_stat stat{};
+        if (!file_stat(index, stat)) {
+            throw zip_exception("zip archive is not open");
+        }
+
+        output.resize(static_cast<size_t>(stat.m_uncomp_size));
+        if (!mz_zip_reader_extract_to_mem(const_cast<mz_zip_archive*>(&archive_), index,
+                output.data(), output.size(), 0)) {
+            throw zip_exception("failed to extract file from archive");
+        }
+    }
+
+    // Same, inflating in dictionary-sized chunks and giving up as soon as
+    // shouldStop() returns true. Returns false if it stopped early.
+    template <typename ShouldStop>
+    bool read(mz_uint index, std::vector<char>& output, ShouldStop shouldStop) const {
+        mz_zip_archive_file_stat stat{};
+        if (!file_stat(index, stat)) {
+            throw zip_exception("zip archive is not open");
+        }
+
+        output.resize(static_cast<size_t>(stat.m_uncomp_size));
+
+        struct Sink {
+            std::vector<char>* output;
+            ShouldStop* shouldStop;
+            bool stopped;
+        } sink{ &output, &shouldStop, false };
+
+        auto write = [](void* opaque, mz_uint64 offset, const void* data, size_t size) -> size_t {
+            auto* target = static_cast<Sink*>(opaque);
+            if ((*target->shouldStop)()) {
+                target->stopped = true;
+                return 0;
+            }
+            if (offset + size > target->output->size()) {
+                return 0;
+            }
+            std::memcpy(target->output->data() + offset, data, size);
+            return size;
+        };
+
+        if (!mz_zip_reader_extract_to_callback(const_cast<mz_zip_archive*>(&archive_), index, write, &sink, 0)) {
+            if (sink.stopped) {
+                return false;
+            }
+            throw zip_exception("failed to extract file from archive");
+        }
+        return true;
+    }
+
 private:
     mutable mz_zip_archive archive_{};
-    std::vector<uint8_t> buffer_{};
+    std::vector<char> buffer_{};
 };
 
 } // namespace miniz_cpp
@@ -15,7 +15,6 @@ struct SpecStats;
 ImVec4 GetTeamColor(const std::string& teamName);
 
 void initMaps();
-void waitForFile(const std::string& filePath);
 std::filesystem::path getArcPath();
 int getBossEncounterNpcDirs();
 
@@ -1,4 +1,6 @@
 #include "gui/BarTemplate.h"
+#include "parser/skill_table.h"
+#include "parser/statistics_helper.h"
 #include "settings/Settings.h"
 #include "utils/Utils.h"
 #include <regex>
@@ -6,6 +8,9 @@
 std::vector<TemplateVariable> BarTemplateRenderer::variables_;
 std::vector<std::string> BarTemplateRenderer::textSegments_;
 
+// Skills listed in a spec bar's tooltip
+static constexpr size_t kTooltipSkillCount = 5;
+
 TemplateVariable::Type BarTemplateRenderer::GetVariableType(int number) {
     switch (number) {
     case 1: return TemplateVariable::Type::PlayerCount;
@@ -144,7 +149,8 @@ void BarTemplateRenderer::RenderTooltipHeader(const std::string& eliteSpec) {
 void BarTemplateRenderer::RenderTooltipStats(
     const SpecStats& stats,
     bool vsLoggedPlayersOnly,
-    int playerCount
+    int playerCount,
+    const std::vector<SkillTotals>* topSkills
 ) {
     //ImGui::Text("Strips: %d", stats.totalStrips);
     ImGui::Text("Players: %d", playerCount);
@@ -160,6 +166,20 @@ void BarTemplateRenderer::RenderTooltipStats(
         stats.totalStrikeDamageVsPlayers : stats.totalStrikeDamage).c_str());
     ImGui::Text("Condition Damage: %s", formatDamage(vsLoggedPlayersOnly ?
         stats.totalCondiDamageVsPlayers : stats.totalCondiDamage).c_str());
+
+    if (topSkills && !topSkills->empty()) {
+        ImGui::Separator();
+        for (const SkillTotals& skill : *topSkills) {
+            const std::string& name = skillNamePool.getName(skill.skill);
+            const uint64_t damage = vsLoggedPlayersOnly ? skill.damageVsPlayers : skill.damage;
+            if (skill.strips != 0) {
+                ImGui::Text("%s: %s, %u strips", name.c_str(), formatDamage(damage).c_str(), skill.strips);
+            }
+            else {
+                ImGui::Text("%s: %s", name.c_str(), formatDamage(damage).c_str());
+            }
+        }
+    }
 }
 
 void BarTemplateRenderer::RenderTemplate(
@@ -171,7 +191,8 @@ void BarTemplateRenderer::RenderTemplate(
     const std::string& sortType,
     HINSTANCE hSelf,
     float fontSize,
-    bool showTooltips
+    bool showTooltips,
+    const SkillBreakdownSource* skillSource
 ) {
     ImVec2 startPos = ImGui::GetCursorPos();
     ImVec2 startScreenPos = ImGui::GetCursorScreenPos();
@@ -204,7 +225,12 @@ void BarTemplateRenderer::RenderTemplate(
         if (isHovered) {
             ImGui::BeginTooltip();
             RenderTooltipHeader(eliteSpec);
-            RenderTooltipStats(stats, vsLoggedPlayersOnly, playerCount);
+            std::vector<SkillTotals> topSkills;
+            if (skillSource && skillSource->table) {
+                topSkills = sumSpecSkills(*skillSource->table, skillSource->teamIDs, eliteSpec,
+                    skillSource->squadOnly, vsLoggedPlayersOnly, kTooltipSkillCount);
+            }
+            RenderTooltipStats(stats, vsLoggedPlayersOnly, playerCount, &topSkills);
             ImGui::EndTooltip();
         }
     }
@@ -1,5 +1,6 @@
 // src/gui/windows/AggregateWindow.cpp
 #include "gui/windows/AggregateWindow.h"
+#include "parser/log_history.h"
 #include "utils/Utils.h"
 #include "resource.h"
 #include "thirdparty/imgui_positioning/imgui_positioning.h"
@@ -52,9 +53,7 @@ namespace wvwfightanalysis::gui {
         float sz = ImGui::GetFontSize();
 
         if (ImGui::Button("Reset Stats")) {
-            std::lock_guard<std::mutex> lock(aggregateStatsMutex);
-            globalAggregateStats = GlobalAggregateStats();
-            cachedAverages = CachedAverages();
+            logHistory.resetAggregates();
         }
 
         std::lock_guard<std::mutex> lock(aggregateStatsMutex);
@@ -1,6 +1,8 @@
 #define NOMINMAX
 #include "gui/windows/MainWindow.h"
 #include "gui/ContentState.h"
+#include "parser/boon_strip_skills.h"
+#include "parser/statistics_helper.h"
 #include "resource.h"
 #include "thirdparty/imgui_positioning/imgui_positioning.h"
 #include <algorithm>
@@ -16,6 +18,9 @@ struct SpecCacheKey {
     bool        vsLoggedPlayersOnly;
     bool        barRepIndependent;
     std::string barRepresentation;
+    // The time range's buckets; both 0 for the whole fight
+    size_t      firstBucket;
+    size_t      endBucket;
 
     bool operator==(const SpecCacheKey& other) const {
         return (logFilename == other.logFilename &&
@@ -24,7 +29,9 @@ struct SpecCacheKey {
             windowSort == other.windowSort &&
             vsLoggedPlayersOnly == other.vsLoggedPlayersOnly &&
             barRepIndependent == other.barRepIndependent &&
-            barRepresentation == other.barRepresentation);
+            barRepresentation == other.barRepresentation &&
+            firstBucket == other.firstBucket &&
+            endBucket == other.endBucket);
     }
 };
 
@@ -48,6 +55,8 @@ struct SpecCacheKeyHasher {
         hashCombine(h, boolHash(key.vsLoggedPlayersOnly));
         hashCombine(h, boolHash(key.barRepIndependent));
         hashCombine(h, strHash(key.barRepresentation));
+        hashCombine(h, std::hash<size_t>{}(key.firstBucket));
+        hashCombine(h, std::hash<size_t>{}(key.endBucket));
 
         return h;
     }
@@ -59,6 +68,15 @@ static std::unordered_map<
     SpecCacheKeyHasher
 > s_specRenderCache;
 
+// The player counter matching the spec sort; a sort by players ranks by damage
+static PlayerStat GetPlayerSortStat(const std::string& windowSort, bool vsLoggedPlayersOnly) {
+    if (windowSort == "down cont") return PlayerStat::DownedContribution;
+    if (windowSort == "kill cont") return PlayerStat::KillContribution;
+    if (windowSort == "deaths") return PlayerStat::Deaths;
+    if (windowSort == "downs") return PlayerStat::Downs;
+    return vsLoggedPlayersOnly ? PlayerStat::DamageVsPlayers : PlayerStat::Damage;
+}
+
 
 namespace wvwfightanalysis::gui {
 
@@ -168,6 +186,12 @@ namespace wvwfightanalysis::gui {
             ImGui::Text("%s", displayName.c_str());
         }
 
+        m_rangeBuckets[0] = 0;
+        m_rangeBuckets[1] = 0;
+        if (settings->showTimeRange) {
+            RenderTimeRangeSlider(currentLog, settings);
+        }
+
         // Setup team names and colors.
         const char* team_names[] = { "Red", "Blue", "Green" };
         const ImVec4 team_colors[] = {
@@ -213,7 +237,7 @@ namespace wvwfightanalysis::gui {
                         if (ImGui::BeginTabItem(tabName.c_str())) {
                             ImGui::PopStyleColor();
                             // Render team-specific data (team name is passed in).
-                            RenderTeamData(*teams[i].stats, teams[i].name, settings, hSelf);
+                            RenderTeamData(currentLogData, *teams[i].stats, teams[i].name, settings, hSelf);
                             ImGui::EndTabItem();
                         }
                         else {
@@ -277,7 +301,7 @@ namespace wvwfightanalysis::gui {
                 for (int i = 0; i < 3; ++i) {
                     if (teams[i].hasData) {
                         ImGui::TableSetColumnIndex(columnIndex++);
-                        RenderTeamData(*teams[i].stats, teams[i].name, settings, hSelf);
+                        RenderTeamData(currentLogData, *teams[i].stats, teams[i].name, settings, hSelf);
                     }
                 }
                 ImGui::EndTable();
@@ -304,6 +328,7 @@ namespace wvwfightanalysis::gui {
     }
 
     void MainWindow::RenderTeamData(
+        const ParsedData& logData,
         const TeamStats& teamData,
         const std::string& teamName,      // NEW PARAM
         const MainWindowSettings* settings,
@@ -360,6 +385,18 @@ namespace wvwfightanalysis::gui {
             else {
                 ImGui::Text("%d", totalPlayers);
             }
+
+            // How many were actually there at once; the peak is the whole team's
+            const float averagePlayers = useSquadStats
+                ? teamData.squadStats.timeWeightedPlayers
+                : teamData.timeWeightedPlayers;
+            if (averagePlayers > 0.0f && ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                ImGui::Text("Average present: %.1f", averagePlayers);
+                if (!useSquadStats)
+                    ImGui::Text("Peak present: %u", static_cast<unsigned>(teamData.timeline.getPeakPlayers()));
+                ImGui::EndTooltip();
+            }
         }
 
         // --- 2) K/D RATIO ---
@@ -462,6 +499,21 @@ namespace wvwfightanalysis::gui {
             else {
                 ImGui::Text("%d", totalStrips);
             }
+
+            // Which strip skills the whole team's strips followed
+            if (!teamData.stripsBySkill.empty() && ImGui::IsItemHovered()) {
+                std::vector<std::pair<uint32_t, uint32_t>> skills(
+                    teamData.stripsBySkill.begin(), teamData.stripsBySkill.end());
+                std::sort(skills.begin(), skills.end(),
+                    [](const auto& a, const auto& b) { return a.second > b.second; });
+
+                ImGui::BeginTooltip();
+                for (const auto& [skillId, strips] : skills) {
+                    const char* skillName = getBoonStripSkillName(skillId);
+                    ImGui::Text("%s: %u", skillName ? skillName : "Other", strips);
+                }
+                ImGui::EndTooltip();
+            }
         }
 
         // --- 6) DAMAGE (vsPlayers or overall) ---
@@ -614,16 +666,267 @@ namespace wvwfightanalysis::gui {
             }
         }
 
-        // --- 11) SPEC BARS (unchanged) ---
+        // --- 11) DAMAGE TIMELINE ---
+        if (settings->showTeamTimeline) {
+            RenderTeamTimeline(teamData, settings);
+        }
+
+        // --- 12) TOP PLAYERS ---
+        if (settings->showTopPlayers) {
+            RenderTopPlayers(logData, teamData, teamName, settings);
+        }
+
+        // --- 13) PARTIES ---
+        if (settings->showSubgroups && teamData.isPOVTeam) {
+            RenderSubgroupPanel(teamData.squadStats, settings);
+        }
+
+        // --- 14) SPEC BARS (unchanged) ---
         if (settings->showSpecBars) {
             ImGui::Separator();
-            RenderSpecializationBars(teamData, teamName, settings, hSelf);
+            RenderSpecializationBars(logData, teamData, teamName, settings, hSelf);
+        }
+    }
+
+
+
+    void MainWindow::RenderTimeRangeSlider(ParsedLog& log,
+        const MainWindowSettings* settings)
+    {
+        const FightRangeIndex* index = log.data.rangeIndex.get();
+        if (!index || index->bucketCount == 0)
+            return;
+
+        const int bucketCount = static_cast<int>(index->bucketCount);
+        const uint64_t bucketSeconds = index->bucketMs / 1000;
+        const uint64_t fightSeconds = (log.data.combatEndTime > log.data.combatStartTime
+            ? log.data.combatEndTime - log.data.combatStartTime + 999
+            : 0) / 1000;
+
+        // A new log starts out showing the whole fight
+        if (log.filename != m_rangeLogFilename) {
+            m_rangeLogFilename = log.filename;
+            m_rangeEdges[0] = 0;
+            m_rangeEdges[1] = bucketCount;
+        }
+
+        // The sliders step over bucket edges, the only places the range index
+        // can cut, and label each edge with its second, the last with the
+        // fight's end
+        auto edgeLabel = [&](int edge) {
+            uint64_t seconds = std::min<uint64_t>(static_cast<uint64_t>(edge) * bucketSeconds, fightSeconds);
+            return std::to_string(seconds) + " s";
+        };
+        const std::string fromLabel = edgeLabel(m_rangeEdges[0]);
+        const std::string toLabel = edgeLabel(m_rangeEdges[1]);
+        const float sliderWidth = (ImGui::GetContentRegionAvail().x - ImGui::GetStyle().ItemSpacing.x) * 0.5f;
+        bool changed = false;
+        ImGui::SetNextItemWidth(sliderWidth);
+        changed |= ImGui::SliderInt("##TimeRangeFrom", &m_rangeEdges[0], 0, bucketCount - 1, fromLabel.c_str());
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(sliderWidth);
+        changed |= ImGui::SliderInt("##TimeRangeTo", &m_rangeEdges[1], 1, bucketCount, toLabel.c_str());
+        if (changed) {
+            m_rangeEdges[0] = std::clamp(m_rangeEdges[0], 0, bucketCount - 1);
+            m_rangeEdges[1] = std::clamp(m_rangeEdges[1], m_rangeEdges[0] + 1, bucketCount);
+            // Spec bars are sorted once per range
+            s_specRenderCache.clear();
+        }
+
+        const size_t firstBucket = static_cast<size_t>(m_rangeEdges[0]);
+        const size_t endBucket = static_cast<size_t>(m_rangeEdges[1]);
+        if (firstBucket == 0 && endBucket >= index->bucketCount)
+            return;
+
+        m_rangeBuckets[0] = firstBucket;
+        m_rangeBuckets[1] = endBucket;
+        log.data = sliceParsedData(log.data, firstBucket, endBucket, Settings::teamIDs);
+    }
+
+    void MainWindow::RenderTeamTimeline(const TeamStats& teamData,
+        const MainWindowSettings* settings)
+    {
+        // The timeline is the whole team's, squad filter or not
+        const TeamTimeline& timeline = teamData.timeline;
+        if (timeline.empty())
+            return;
+
+        const std::vector<uint32_t>& damage = settings->vsLoggedPlayersOnly
+            ? timeline.damageVsPlayers
+            : timeline.damage;
+        const uint32_t peak = *std::max_element(damage.begin(), damage.end());
+
+        // Damage per second as a sparkline; hovering shows the second and value
+        const float width = ImGui::GetContentRegionAvail().x;
+        const float height = ImGui::GetFontSize() * 2.0f;
+        ImGui::PlotLines("##TeamTimeline",
+            [](void* data, int idx) {
+                return static_cast<float>((*static_cast<const std::vector<uint32_t>*>(data))[idx]);
+            },
+            const_cast<std::vector<uint32_t>*>(&damage),
+            static_cast<int>(damage.size()),
+            0, nullptr, 0.0f, static_cast<float>(std::max<uint32_t>(peak, 1)),
+            ImVec2(width, height));
+
+        // Downs and deaths as ticks under the line, deaths drawn over downs
+        const ImVec2 plotMin = ImGui::GetItemRectMin();
+        const ImVec2 plotMax = ImGui::GetItemRectMax();
+        const float tickHeight = 4.0f;
+        const float bucketWidth = (plotMax.x - plotMin.x) / static_cast<float>(timeline.size());
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const ImU32 downColor = IM_COL32(0xFF, 0xAA, 0x33, 0xFF);
+        const ImU32 deathColor = IM_COL32(0xFF, 0x44, 0x44, 0xFF);
+        for (size_t i = 0; i < timeline.size(); ++i) {
+            if (timeline.downs[i] == 0 && timeline.deaths[i] == 0)
+                continue;
+            const float x = plotMin.x + bucketWidth * static_cast<float>(i);
+            drawList->AddRectFilled(
+                ImVec2(x, plotMax.y + 1.0f),
+                ImVec2(x + std::max(bucketWidth, 1.0f), plotMax.y + 1.0f + tickHeight),
+                timeline.deaths[i] != 0 ? deathColor : downColor);
         }
+        ImGui::Dummy(ImVec2(width, tickHeight + 2.0f));
+
+        ImGui::Text("Peak: %s/s", formatDamage(peak).c_str());
     }
 
+    void MainWindow::RenderSubgroupPanel(const SquadStats& squad,
+        const MainWindowSettings* settings)
+    {
+        // Parties with anyone in them, and the one doing least per head
+        std::vector<size_t> parties;
+        size_t weakest = kMaxSubgroups;
+        double weakestPerPlayer = 0.0;
+        for (size_t i = 0; i < kMaxSubgroups; ++i) {
+            const SpecStats& party = squad.subgroupStats[i];
+            if (party.count == 0)
+                continue;
+            parties.push_back(i);
+            const uint64_t damage = settings->vsLoggedPlayersOnly ? party.totalDamageVsPlayers : party.totalDamage;
+            const double perPlayer = static_cast<double>(damage) / party.count;
+            if (weakest == kMaxSubgroups || perPlayer < weakestPerPlayer) {
+                weakest = i;
+                weakestPerPlayer = perPlayer;
+            }
+        }
+        if (parties.size() < 2)
+            return;
 
+        ImGui::Separator();
+        const ImGuiTableFlags flags = ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg;
+        if (!ImGui::BeginTable("PartyTable", 8, flags))
+            return;
 
-    void MainWindow::RenderSpecializationBars(const TeamStats& teamData,
+        ImGui::TableSetupColumn("Party");
+        ImGui::TableSetupColumn("Plr");
+        ImGui::TableSetupColumn("Dmg");
+        ImGui::TableSetupColumn("Dmg/plr");
+        ImGui::TableSetupColumn("Down");
+        ImGui::TableSetupColumn("Kill");
+        ImGui::TableSetupColumn("Strips");
+        ImGui::TableSetupColumn("Deaths");
+        ImGui::TableHeadersRow();
+
+        const ImVec4 weakColor = ImGui::ColorConvertU32ToFloat4(IM_COL32(0xFF, 0x88, 0x55, 0xFF));
+        for (size_t i : parties) {
+            const SpecStats& party = squad.subgroupStats[i];
+            const uint64_t damage = settings->vsLoggedPlayersOnly ? party.totalDamageVsPlayers : party.totalDamage;
+            const uint64_t downCont = settings->vsLoggedPlayersOnly
+                ? party.totalDownedContributionVsPlayers
+                : party.totalDownedContribution;
+            const uint64_t killCont = settings->vsLoggedPlayersOnly
+                ? party.totalKillContributionVsPlayers
+                : party.totalKillContribution;
+            const uint64_t strips = settings->vsLoggedPlayersOnly ? party.totalStripsVsPlayers : party.totalStrips;
+
+            const bool isWeakest = i == weakest;
+            if (isWeakest)
+                ImGui::PushStyleColor(ImGuiCol_Text, weakColor);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", i + 1);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", party.count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", formatDamage(damage).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", formatDamage(damage / party.count).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", formatDamage(downCont).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", formatDamage(killCont).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(strips));
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", party.totalDeaths);
+
+            if (isWeakest)
+                ImGui::PopStyleColor();
+        }
+        ImGui::EndTable();
+    }
+
+    void MainWindow::RenderTopPlayers(const ParsedData& logData,
+        const TeamStats& teamData,
+        const std::string& teamName,
+        const MainWindowSettings* settings)
+    {
+        const PlayerStatsTable* players = logData.players.get();
+        if (!players || players->size() == 0)
+            return;
+
+        // The raw team IDs shown under this name
+        std::vector<uint32_t> teamIds;
+        for (const auto& [teamId, _] : logData.teamStatsById) {
+            if (resolveTeamName(teamId, logData.logTeamNames, Settings::teamIDs) == teamName)
+                teamIds.push_back(teamId);
+        }
+
+        const bool useSquadStats = settings->squadPlayersOnly && teamData.isPOVTeam;
+        const PlayerStat stat = GetPlayerSortStat(settings->windowSort, settings->vsLoggedPlayersOnly);
+        uint64_t total = 0;
+        const std::vector<uint32_t> rows = selectTopPlayers(*players, stat,
+            static_cast<size_t>(settings->topPlayersCount),
+            [&](uint32_t row) {
+                if (useSquadStats && !players->inSquad[row])
+                    return false;
+                return std::find(teamIds.begin(), teamIds.end(), players->teamIDs[row]) != teamIds.end();
+            },
+            &total);
+        if (rows.empty())
+            return;
+
+        const bool isDamage = stat == PlayerStat::Damage || stat == PlayerStat::DamageVsPlayers ||
+            stat == PlayerStat::DownedContribution || stat == PlayerStat::KillContribution;
+        const std::vector<uint64_t>& values = players->counters.column(stat);
+
+        ImGui::Separator();
+        for (size_t rank = 0; rank < rows.size(); ++rank) {
+            const uint32_t row = rows[rank];
+            const std::string& spec = players->eliteSpecs[row];
+            const std::string value = isDamage
+                ? formatDamage(values[row])
+                : std::to_string(values[row]);
+            const float share = total > 0 ? 100.0f * static_cast<float>(values[row]) / static_cast<float>(total) : 0.0f;
+
+            const std::string& name = players->names[row].empty() ? spec : players->names[row];
+            if (settings->showClassNames) {
+                auto shortIt = eliteSpecShortNames.find(spec);
+                const std::string& specLabel = settings->useShortClassNames && shortIt != eliteSpecShortNames.end()
+                    ? shortIt->second
+                    : spec;
+                ImGui::Text("%zu. %s (%s)  %s  %.0f%%", rank + 1, name.c_str(), specLabel.c_str(),
+                    value.c_str(), share);
+            }
+            else {
+                ImGui::Text("%zu. %s  %s  %.0f%%", rank + 1, name.c_str(), value.c_str(), share);
+            }
+        }
+    }
+
+    void MainWindow::RenderSpecializationBars(const ParsedData& logData,
+        const TeamStats& teamData,
         const std::string& teamName,      // NEW PARAM
         const MainWindowSettings* settings,
         HINSTANCE hSelf)
@@ -648,7 +951,9 @@ namespace wvwfightanalysis::gui {
             settings->windowSort,
             settings->vsLoggedPlayersOnly,
             settings->barRepIndependent,
-            settings->barRepresentation
+            settings->barRepresentation,
+            m_rangeBuckets[0],
+            m_rangeBuckets[1]
         };
 
         // 3) Look up in our global s_specRenderCache
@@ -676,6 +981,18 @@ namespace wvwfightanalysis::gui {
         // 4) Use the cached data
         const auto& sortedClasses = it->second;
 
+        // The skill groups the tooltips break down: this team's raw IDs, and
+        // only the squad's when showing squad stats
+        SkillBreakdownSource skillSource;
+        skillSource.table = logData.skills.get();
+        skillSource.squadOnly = useSquadStats;
+        if (skillSource.table) {
+            for (const auto& [teamId, _] : logData.teamStatsById) {
+                if (resolveTeamName(teamId, logData.logTeamNames, Settings::teamIDs) == teamName)
+                    skillSource.teamIDs.push_back(teamId);
+            }
+        }
+
         // ----- The rest is your existing bar-drawing code -----
         ImDrawList* drawList = ImGui::GetWindowDrawList();
         const float spacing = 2.0f;
@@ -771,7 +1088,7 @@ namespace wvwfightanalysis::gui {
             }
 
             // Defer text rendering
-            textRenderers.push_back([=, &stat, &settings]() {
+            textRenderers.push_back([=, &stat, &settings, &skillSource]() {
                 ImGui::SetCursorPos(ImVec2(
                     initialCursorPos.x + 5.0f,
                     initialCursorPos.y + 2.0f
@@ -786,7 +1103,8 @@ namespace wvwfightanalysis::gui {
                     settings->windowSort,
                     hSelf,
                     ImGui::GetFontSize(),
-                    settings->showSpecTooltips
+                    settings->showSpecTooltips,
+                    &skillSource
                 );
                 });
 
@@ -903,6 +1221,7 @@ namespace wvwfightanalysis::gui {
         // Display Settings
         if (ImGui::BeginMenu("Display")) {
             if (ImGui::Checkbox("log name", &settings->showLogName)) Settings::RequestSave(SettingsPath);
+            if (ImGui::Checkbox("time range slider", &settings->showTimeRange)) Settings::RequestSave(SettingsPath);
             if (ImGui::Checkbox("short spec names", &settings->useShortClassNames)) Settings::RequestSave(SettingsPath);
             if (ImGui::Checkbox("draw bars", &settings->showSpecBars)) Settings::RequestSave(SettingsPath);
             if (ImGui::Checkbox("tooltips", &settings->showSpecTooltips)) Settings::RequestSave(SettingsPath);
@@ -918,6 +1237,13 @@ namespace wvwfightanalysis::gui {
                 if (ImGui::Checkbox("outgoing kill cont", &settings->showTeamKillCont)) { Settings::RequestSave(SettingsPath); }
                 if (ImGui::Checkbox("outgoing strike damage", &settings->showTeamStrikeDamage)) { Settings::RequestSave(SettingsPath); }
                 if (ImGui::Checkbox("outgoing condi damage", &settings->showTeamCondiDamage)) { Settings::RequestSave(SettingsPath); }
+                if (ImGui::Checkbox("damage timeline", &settings->showTeamTimeline)) { Settings::RequestSave(SettingsPath); }
+                if (ImGui::Checkbox("party breakdown", &settings->showSubgroups)) { Settings::RequestSave(SettingsPath); }
+                if (ImGui::Checkbox("top players", &settings->showTopPlayers)) { Settings::RequestSave(SettingsPath); }
+                if (settings->showTopPlayers) {
+                    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8.0f);
+                    if (ImGui::SliderInt("players shown", &settings->topPlayersCount, 1, 20)) { Settings::RequestSave(SettingsPath); }
+                }
                 ImGui::EndMenu();
             }
 
@@ -2,8 +2,15 @@
 #include "settings/Settings.h"
 #include "shared/Shared.h"
 #include "utils/Utils.h"
+#include "parser/directory_monitor.h"
 #include "parser/evtc_parser.h"
+#include "parser/file_helpers.h"
+#include "parser/log_history.h"
+#include "parser/packed_log.h"
+#include "parser/parse_metrics.h"
+#include "parser/parse_scheduler.h"
 #include "imgui/imgui.h"
+#include <thread>
 
 namespace {
 
@@ -40,10 +47,222 @@ namespace {
         }
     }
 
+    void RenderLatencyRow(const char* label, const LatencyStat& stat) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(label);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(stat.count.load(std::memory_order_relaxed)));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f ms", stat.getAverageMilliseconds());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f ms", stat.getMaxMilliseconds());
+    }
+
+    void RenderMemoryRow(const char* label, size_t items, size_t bytes) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(label);
+        ImGui::TableNextColumn();
+        ImGui::Text("%zu", items);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f KB", bytes / 1024.0);
+        ImGui::TableNextColumn();
+        if (items > 0) {
+            ImGui::Text("%.2f KB", bytes / 1024.0 / items);
+        }
+    }
+
+    void RenderMemoryRow(const char* label, size_t bytes) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(label);
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted("-");
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f KB", bytes / 1024.0);
+        ImGui::TableNextColumn();
+    }
+
+    void RenderMemoryUsage() {
+        size_t shownLogs = 0;
+        size_t shownBytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(parsedLogsMutex);
+            shownLogs = parsedLogs.size();
+            for (const auto& log : parsedLogs) {
+                shownBytes += sizeof(ParsedLog) + log.filename.capacity() + estimateMemoryUsage(log.data);
+            }
+        }
+        LogHistory::MemoryUsage history = logHistory.getMemoryUsage();
+
+        if (ImGui::BeginTable("MemoryUsage", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Memory");
+            ImGui::TableSetupColumn("Items");
+            ImGui::TableSetupColumn("Total");
+            ImGui::TableSetupColumn("Per Item");
+            ImGui::TableHeadersRow();
+
+            RenderMemoryRow("Shown logs", shownLogs, shownBytes);
+            RenderMemoryRow("Stored fights (packed)", history.packedLogs, history.packedBytes);
+            RenderMemoryRow("Fight details (range, players, skills)", history.sharedDetailLogs, history.sharedDetailBytes);
+            RenderMemoryRow("Fight summaries", history.summaries, history.summaryBytes);
+            RenderMemoryRow("Directory index", getLogIndexMemoryUsage());
+            RenderMemoryRow("Idle inflate buffers", getParseBufferMemoryUsage());
+
+            ImGui::EndTable();
+        }
+    }
+
+    void RenderDiagnostics() {
+        constexpr size_t compressed = static_cast<size_t>(LogSourceKind::Compressed);
+        constexpr size_t uncompressed = static_cast<size_t>(LogSourceKind::Uncompressed);
+
+        if (ImGui::BeginTable("ParseLatency", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Step");
+            ImGui::TableSetupColumn("Logs");
+            ImGui::TableSetupColumn("Average");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableHeadersRow();
+
+            RenderLatencyRow("Inflate (.zevtc)", parseMetrics.load[compressed]);
+            RenderLatencyRow("Parse (.zevtc)", parseMetrics.parse[compressed]);
+            RenderLatencyRow("Map (.evtc)", parseMetrics.load[uncompressed]);
+            RenderLatencyRow("Parse (.evtc)", parseMetrics.parse[uncompressed]);
+            RenderLatencyRow("Stats pass", parseMetrics.accumulate);
+            RenderLatencyRow("Wait for writer", parseMetrics.readiness);
+            RenderLatencyRow("Detection to publish", parseMetrics.detectionToPublish);
+            RenderLatencyRow("Stop monitoring", parseMetrics.monitorShutdown);
+
+            ImGui::EndTable();
+        }
+
+        if (ImGui::BeginTable("FrameTime", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Frame Time");
+            ImGui::TableSetupColumn("Frames");
+            ImGui::TableSetupColumn("Average");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableHeadersRow();
+
+            RenderLatencyRow("Idle", parseMetrics.idleFrames);
+            RenderLatencyRow("Parsing", parseMetrics.parsingFrames);
+            RenderLatencyRow("In combat, idle", parseMetrics.combatIdleFrames);
+            RenderLatencyRow("In combat, full speed",
+                parseMetrics.combatParsingFrames[static_cast<size_t>(CombatParsePolicy::FullSpeed)]);
+            RenderLatencyRow("In combat, lower priority",
+                parseMetrics.combatParsingFrames[static_cast<size_t>(CombatParsePolicy::LowerPriority)]);
+            RenderLatencyRow("In combat, throttled",
+                parseMetrics.combatParsingFrames[static_cast<size_t>(CombatParsePolicy::Throttle)]);
+
+            ImGui::EndTable();
+        }
+        ImGui::Text("Parser held back in combat: %.1f s",
+            parseMetrics.combatThrottle.totalMicros.load(std::memory_order_relaxed) / 1000000.0);
+
+        RenderMemoryUsage();
+
+        if (ImGui::Button("Reset Metrics")) {
+            parseMetrics.reset();
+        }
+    }
+
 } // namespace
 
 namespace wvwfightanalysis::gui {
 
+    OptionsWindow::~OptionsWindow()
+    {
+        StopBenchmark();
+    }
+
+    void OptionsWindow::StopBenchmark()
+    {
+        benchmarkCancelled.store(true);
+        if (benchmarkThread.joinable()) {
+            benchmarkThread.join();
+        }
+        benchmarkCancelled.store(false);
+    }
+
+    void OptionsWindow::RenderAccumulationBenchmark()
+    {
+        const bool running = benchmarkRunning.load();
+        std::filesystem::path logPath = getLargestParsedLogPath();
+
+        // Greyed out and ignored while a run is in flight
+        if (running) {
+            ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+        }
+        const bool clicked = ImGui::Button(running ? "Benchmarking..." : "Benchmark Accumulation");
+        if (running) {
+            ImGui::PopStyleVar();
+        }
+        if (clicked && !running && !logPath.empty()) {
+            // The previous run's thread has finished; reap it before starting another.
+            if (benchmarkThread.joinable()) {
+                benchmarkThread.join();
+            }
+            benchmarkRunning.store(true);
+            ParserSettingsSnapshot settings = Settings::GetParserSettingsSnapshot();
+            benchmarkThread = std::thread([this, logPath, settings]() {
+                std::vector<AccumulationBenchmarkRun> runs =
+                    benchmarkAccumulation(logPath, settings, CancellationToken(benchmarkCancelled));
+                if (!benchmarkCancelled.load()) {
+                    std::lock_guard<std::mutex> lock(benchmarkMutex);
+                    benchmarkRuns = std::move(runs);
+                    benchmarkLog = getUtf8Path(logPath.filename());
+                }
+                benchmarkRunning.store(false);
+                });
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip(logPath.empty()
+                ? "No WvW log parsed yet."
+                : "Times the stats pass over the largest log seen this session at 1 to 16 threads.");
+        }
+        if (running) {
+            ImGui::SameLine();
+            if (ImGui::Button("Cancel##AccumulationBenchmark")) {
+                benchmarkCancelled.store(true);
+            }
+        }
+        else if (benchmarkCancelled.load() && benchmarkThread.joinable()) {
+            benchmarkThread.join();
+            benchmarkCancelled.store(false);
+        }
+
+        std::lock_guard<std::mutex> lock(benchmarkMutex);
+        if (benchmarkRuns.empty()) {
+            return;
+        }
+
+        ImGui::Text("Log: %s", benchmarkLog.c_str());
+        if (ImGui::BeginTable("AccumulationBenchmark", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Threads");
+            ImGui::TableSetupColumn("Best");
+            ImGui::TableSetupColumn("Speedup");
+            ImGui::TableSetupColumn("Matches");
+            ImGui::TableHeadersRow();
+
+            double sequential = benchmarkRuns.front().milliseconds;
+            for (const auto& run : benchmarkRuns) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", run.threads);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f ms", run.milliseconds);
+                ImGui::TableNextColumn();
+                if (run.milliseconds > 0.0) {
+                    ImGui::Text("%.2fx", sequential / run.milliseconds);
+                }
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(run.matchesSequential ? "Yes" : "No");
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
     void OptionsWindow::Render()
     {
         ImGui::Text("WvW Fight Analysis Settings");
@@ -69,6 +288,7 @@ namespace wvwfightanalysis::gui {
                         Settings::logHistorySize = static_cast<size_t>(std::clamp(tempLogHistorySize, 1, 20));
                         Settings::Settings[LOG_HISTORY_SIZE] = Settings::logHistorySize;
                     }
+                    historyRefreshPending = true;
                     Settings::RequestSave(SettingsPath);
                 }
                 if (ImGui::IsItemHovered()) {
@@ -94,10 +314,11 @@ namespace wvwfightanalysis::gui {
                         Settings::minTotalPlayers = std::clamp(minTotalPlayers, 0, 50);
                         Settings::Settings[MIN_TOTAL_PLAYERS] = Settings::minTotalPlayers;
                     }
+                    historyRefreshPending = true;
                     Settings::RequestSave(SettingsPath);
                 }
                 if (ImGui::IsItemHovered()) {
-                    ImGui::SetTooltip("Skip parsing logs with fewer than this many total identified players.");
+                    ImGui::SetTooltip("Hide logs with fewer than this many total identified players.");
                 }
 
                 int minTotalDeaths = Settings::minTotalDeaths;
@@ -107,10 +328,11 @@ namespace wvwfightanalysis::gui {
                         Settings::minTotalDeaths = std::clamp(minTotalDeaths, 0, 50);
                         Settings::Settings[MIN_TOTAL_DEATHS] = Settings::minTotalDeaths;
                     }
+                    historyRefreshPending = true;
                     Settings::RequestSave(SettingsPath);
                 }
                 if (ImGui::IsItemHovered()) {
-                    ImGui::SetTooltip("Skip parsing logs with fewer than this many total deaths.");
+                    ImGui::SetTooltip("Hide logs with fewer than this many total deaths.");
                 }
 
                 int minTotalDowns = Settings::minTotalDowns;
@@ -120,10 +342,11 @@ namespace wvwfightanalysis::gui {
                         Settings::minTotalDowns = std::clamp(minTotalDowns, 0, 50);
                         Settings::Settings[MIN_TOTAL_DOWNS] = Settings::minTotalDowns;
                     }
+                    historyRefreshPending = true;
                     Settings::RequestSave(SettingsPath);
                 }
                 if (ImGui::IsItemHovered()) {
-                    ImGui::SetTooltip("Skip parsing logs with fewer than this many total downs.");
+                    ImGui::SetTooltip("Hide logs with fewer than this many total downs.");
                 }
 
                 int minCombatDuration = Settings::minCombatDuration;
@@ -133,10 +356,39 @@ namespace wvwfightanalysis::gui {
                         Settings::minCombatDuration = std::clamp(minCombatDuration, 0, 120);
                         Settings::Settings[MIN_COMBAT_DURATION] = Settings::minCombatDuration;
                     }
+                    historyRefreshPending = true;
                     Settings::RequestSave(SettingsPath);
                 }
                 if (ImGui::IsItemHovered()) {
-                    ImGui::SetTooltip("Skip parsing logs with combat duration shorter than this (seconds).");
+                    ImGui::SetTooltip("Hide logs with combat duration shorter than this (seconds).");
+                }
+
+                std::vector<uint32_t> unknownTeamIds = logHistory.getUnknownTeamIds();
+                if (!unknownTeamIds.empty()) {
+                    ImGui::Text("Unknown Team IDs");
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("Teams in recent logs that could not be named. Assigning a color relabels every kept log.");
+                    }
+
+                    const char* teamColorOptions[] = {
+                        "Unassigned",
+                        "Red",
+                        "Blue",
+                        "Green"
+                    };
+                    for (uint32_t teamId : unknownTeamIds) {
+                        int selectedTeamColor = 0;
+                        std::string label = "Team " + std::to_string(teamId);
+                        if (ImGui::Combo(label.c_str(), &selectedTeamColor, teamColorOptions, IM_ARRAYSIZE(teamColorOptions)) &&
+                            selectedTeamColor > 0) {
+                            {
+                                std::lock_guard<std::mutex> lock(Settings::Mutex);
+                                Settings::teamIDs[static_cast<int>(teamId)] = teamColorOptions[selectedTeamColor];
+                            }
+                            historyRefreshPending = true;
+                            Settings::RequestSave(SettingsPath);
+                        }
+                    }
                 }
 
                 bool showNewParseAlert = Settings::showNewParseAlert;
@@ -178,6 +430,38 @@ namespace wvwfightanalysis::gui {
                     }
                 }
 
+                int tempParserWorkerCount = static_cast<int>(Settings::parserWorkerCount);
+                if (ImGui::InputInt("Parser Threads", &tempParserWorkerCount)) {
+                    {
+                        std::lock_guard<std::mutex> lock(Settings::Mutex);
+                        Settings::parserWorkerCount = static_cast<size_t>(std::clamp(tempParserWorkerCount, 1, 8));
+                        Settings::Settings[PARSER_WORKER_COUNT] = Settings::parserWorkerCount;
+                    }
+                    Settings::RequestSave(SettingsPath);
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("Threads per stage used to inflate and parse logs. Takes effect when directory monitoring restarts.");
+                }
+
+                const char* combatParseOptions[] = {
+                    "Full Speed",
+                    "Lower Priority",
+                    "Throttle"
+                };
+                int selectedCombatParsePolicy = Settings::combatParsePolicy;
+                if (ImGui::Combo("Parsing In Combat", &selectedCombatParsePolicy, combatParseOptions, IM_ARRAYSIZE(combatParseOptions))) {
+                    {
+                        std::lock_guard<std::mutex> lock(Settings::Mutex);
+                        Settings::combatParsePolicy = std::clamp(selectedCombatParsePolicy, 0, 2);
+                        Settings::Settings[COMBAT_PARSE_POLICY] = Settings::combatParsePolicy;
+                    }
+                    parseScheduler.setPolicy(static_cast<CombatParsePolicy>(Settings::combatParsePolicy));
+                    Settings::RequestSave(SettingsPath);
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("How hard logs are parsed while you are in combat. Lower Priority lets the game go first; Throttle also caps parser CPU time. Out of combat logs always parse at full speed.");
+                }
+
                 bool debugStringsMode = Settings::debugStringsMode;
                 if (ImGui::Checkbox("Enable Debug Logging", &debugStringsMode)) {
                     {
@@ -217,9 +501,12 @@ namespace wvwfightanalysis::gui {
                 if (ImGui::Button("Restart Directory Monitoring") && enabled) {
                     isRestartInProgress.store(true);
                     std::thread([]() {
-                        stopMonitoring = true;
-                        if (directoryMonitorThread.joinable()) {
-                            directoryMonitorThread.join();
+                        {
+                            ScopedLatency shutdownTimer(parseMetrics.monitorShutdown);
+                            requestStopMonitoring();
+                            if (directoryMonitorThread.joinable()) {
+                                directoryMonitorThread.join();
+                            }
                         }
                         stopMonitoring = false;
                         ParserSettingsSnapshot settings = Settings::GetParserSettingsSnapshot();
@@ -363,8 +650,23 @@ namespace wvwfightanalysis::gui {
                 ImGui::EndTabItem();
             }
 
+            // Diagnostics
+            if (ImGui::BeginTabItem("Diagnostics"))
+            {
+                RenderDiagnostics();
+                RenderAccumulationBenchmark();
+                ImGui::EndTabItem();
+            }
+
             ImGui::EndTabBar();
         }
+
+        // Rebuilding the history view unpacks every shown log, so it waits
+        // until the threshold being typed in or stepped is let go.
+        if (historyRefreshPending && !ImGui::IsAnyItemActive()) {
+            historyRefreshPending = false;
+            logHistory.refresh(Settings::GetParserSettingsSnapshot());
+        }
     }
 
 } // namespace wvwfightanalysis::gui
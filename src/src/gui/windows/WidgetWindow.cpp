@@ -185,6 +185,11 @@ static float ResolveAnimationTime(std::atomic<float>& animationTime, float rende
                         teamCountValue = static_cast<float>(
                             useSquadStats ? teamIt->second.squadStats.totalPlayers : teamIt->second.totalPlayers);
                     }
+                    else if (settings->widgetStats == "avg_players") {
+                        teamCountValue = useSquadStats
+                            ? teamIt->second.squadStats.timeWeightedPlayers
+                            : teamIt->second.timeWeightedPlayers;
+                    }
                     else if (settings->widgetStats == "deaths") {
                         teamCountValue = static_cast<float>(
                             useSquadStats ? teamIt->second.squadStats.totalDeaths : teamIt->second.totalDeaths);
@@ -211,6 +216,9 @@ static float ResolveAnimationTime(std::atomic<float>& animationTime, float rende
                     else if (settings->widgetStats == "kdr") {
                         snprintf(buf, sizeof(buf), "%.2f", teamCountValue);
                     }
+                    else if (settings->widgetStats == "avg_players") {
+                        snprintf(buf, sizeof(buf), "%.1f", teamCountValue);
+                    }
                     else {
                         snprintf(buf, sizeof(buf), "%.0f", teamCountValue);
                     }
@@ -279,7 +287,7 @@ static float ResolveAnimationTime(std::atomic<float>& animationTime, float rende
     }
 
     ImTextureID WidgetWindow::GetStatIcon(const WidgetWindowSettings* settings) {
-        if (settings->widgetStats == "players") return Squad ? Squad->Resource : nullptr;
+        if (settings->widgetStats == "players" || settings->widgetStats == "avg_players") return Squad ? Squad->Resource : nullptr;
         if (settings->widgetStats == "deaths") return Death ? Death->Resource : nullptr;
         if (settings->widgetStats == "downs") return Downed ? Downed->Resource : nullptr;
         if (settings->widgetStats == "damage") return Damage ? Damage->Resource : nullptr;
@@ -292,7 +300,7 @@ static float ResolveAnimationTime(std::atomic<float>& animationTime, float rende
             return nullptr;
         }
 
-        if (settings->widgetStats == "players" && !Squad) {
+        if ((settings->widgetStats == "players" || settings->widgetStats == "avg_players") && !Squad) {
             Squad = APIDefs->Textures.GetOrCreateFromResource("SQUAD_ICON", SQUAD, hSelf);
         }
         else if (settings->widgetStats == "deaths" && !Death) {
@@ -361,8 +369,8 @@ static float ResolveAnimationTime(std::atomic<float>& animationTime, float rende
 
     void WidgetWindow::RenderDisplayStatsMenu(WidgetWindowSettings* settings) {
         if (ImGui::BeginMenu("Display Stats")) {
-            constexpr std::array<const char*, 5> statOptions = { "Players", "K/D Ratio", "Deaths", "Downs", "Damage" };
-            constexpr std::array<const char*, 5> statValues = { "players", "kdr", "deaths", "downs", "damage" };
+            constexpr std::array<const char*, 6> statOptions = { "Players", "Avg Players", "K/D Ratio", "Deaths", "Downs", "Damage" };
+            constexpr std::array<const char*, 6> statValues = { "players", "avg_players", "kdr", "deaths", "downs", "damage" };
 
             for (size_t i = 0; i < statOptions.size(); ++i) {
                 const bool isSelected = settings->widgetStats == statValues[i];
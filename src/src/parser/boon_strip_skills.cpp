@@ -1,11 +1,42 @@
 // boon_strip_skills.cpp
 #include "parser/boon_strip_skills.h"
+#include <array>
 
-// Define the set (only once in the program)
-const std::unordered_set<uint32_t> knownBoonStripSkills = {
-    10602,  // Corrupt Boon (Necro)
-    10698,  // Null Field (Mesmer)
-    30792,  // Break Enchantments (Warrior)
-    30088,  // Winds of Disenchantment (Spellbreaker)
-    // Add more known boon strip skills as identified
-};
\ No newline at end of file
+namespace {
+    // Skill IDs are well below this; the table costs 32 KB
+    constexpr uint32_t kSkillIdLimit = 1u << 18;
+    using SkillBits = std::array<uint64_t, kSkillIdLimit / 64>;
+
+    constexpr bool allSkillIdsInRange() {
+        for (const BoonStripSkill& skill : knownBoonStripSkills) {
+            if (skill.id >= kSkillIdLimit) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(allSkillIdsInRange(), "Boon strip skill ID above kSkillIdLimit");
+
+    constexpr SkillBits makeStripSkillBits() {
+        SkillBits bits{};
+        for (const BoonStripSkill& skill : knownBoonStripSkills) {
+            bits[skill.id / 64] |= uint64_t{ 1 } << (skill.id % 64);
+        }
+        return bits;
+    }
+
+    constexpr SkillBits kStripSkillBits = makeStripSkillBits();
+}
+
+bool isBoonStripSkill(uint32_t skillId) {
+    return skillId < kSkillIdLimit && (kStripSkillBits[skillId / 64] >> (skillId % 64)) & 1;
+}
+
+const char* getBoonStripSkillName(uint32_t skillId) {
+    for (const BoonStripSkill& skill : knownBoonStripSkills) {
+        if (skill.id == skillId) {
+            return skill.name;
+        }
+    }
+    return nullptr;
+}
@@ -1,48 +1,38 @@
 #include "parser/boon_strip_tracker.h"
-#include <algorithm>
 
 void BoonStripTracker::trackSkillActivation(uint16_t srcInstid, uint32_t skillId, uint64_t timestamp) {
-    if (knownBoonStripSkills.count(skillId) > 0) {
-        playerSkillActivations[srcInstid].push_back(timestamp);
+    if (!isBoonStripSkill(skillId)) {
+        return;
     }
-}
-
-bool BoonStripTracker::hasRecentStripSkill(uint16_t instid, uint64_t currentTime, uint64_t windowMs) {
-    if (windowMs == 0) windowMs = DEFAULT_WINDOW_MS;
 
-    auto it = playerSkillActivations.find(instid);
-    if (it == playerSkillActivations.end()) return false;
+    ActivationRing& ring = activationsByInstid[srcInstid];
+    ring.times[ring.next] = timestamp;
+    ring.skillIds[ring.next] = skillId;
+    ring.next = static_cast<uint8_t>((ring.next + 1) % kActivationsPerAgent);
+    if (ring.size < kActivationsPerAgent) {
+        ++ring.size;
+    }
+}
 
-    // Check from most recent activations first (optimization)
-    for (auto timeIt = it->second.rbegin(); timeIt != it->second.rend(); ++timeIt) {
-        uint64_t activationTime = *timeIt;
+uint32_t BoonStripTracker::findRecentStripSkill(uint16_t instid, uint64_t currentTime, uint64_t windowMs) const {
+    auto it = activationsByInstid.find(instid);
+    if (it == activationsByInstid.end()) {
+        return 0;
+    }
 
-        // Within the temporal window?
-        if (currentTime >= activationTime && currentTime - activationTime <= windowMs) {
-            return true;
+    // Check from most recent activations first
+    const ActivationRing& ring = it->second;
+    for (size_t age = 1; age <= ring.size; ++age) {
+        size_t slot = (ring.next + kActivationsPerAgent - age) % kActivationsPerAgent;
+        uint64_t activationTime = ring.times[slot];
+        if (activationTime > currentTime) {
+            continue;
         }
-
         // Beyond our window, no need to check older activations
         if (currentTime - activationTime > windowMs) {
             break;
         }
+        return ring.skillIds[slot];
     }
-    return false;
+    return 0;
 }
-
-void BoonStripTracker::cleanupOldActivations(uint64_t currentTime, uint64_t expirationMs) {
-    // Only clean up periodically for performance
-    if (expirationMs == 0) expirationMs = CLEANUP_INTERVAL_MS;
-
-    if (lastCleanupTime == 0 || currentTime - lastCleanupTime >= CLEANUP_INTERVAL_MS) {
-        for (auto& [instid, activations] : playerSkillActivations) {
-            activations.erase(
-                std::remove_if(activations.begin(), activations.end(),
-                    [currentTime, expirationMs](uint64_t activationTime) {
-                        return currentTime - activationTime > expirationMs;
-                    }),
-                activations.end());
-        }
-        lastCleanupTime = currentTime;
-    }
-}
\ No newline at end of file
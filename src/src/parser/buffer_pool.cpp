@@ -0,0 +1,94 @@
+#include "parser/buffer_pool.h"
+#include <utility>
+
+namespace {
+    // Two buffers per parse (compressed input + inflated output), one spare.
+    constexpr size_t kMaxIdleDecompressionBuffers = 3;
+    // Big enough for nearly every WvW log; anything larger is freed after use.
+    constexpr size_t kMaxRetainedDecompressionBytes = 64 * 1024 * 1024;
+}
+
+BufferPool::Lease::Lease(BufferPool* pool, std::vector<char>&& buffer)
+    : pool(pool), buffer(std::move(buffer)) {
+}
+
+BufferPool::Lease::~Lease() {
+    if (pool) {
+        pool->release(std::move(buffer));
+    }
+}
+
+BufferPool::Lease::Lease(Lease&& other) noexcept
+    : pool(other.pool), buffer(std::move(other.buffer)) {
+    other.pool = nullptr;
+}
+
+BufferPool::Lease& BufferPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (pool) {
+            pool->release(std::move(buffer));
+        }
+        pool = other.pool;
+        buffer = std::move(other.buffer);
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+BufferPool::BufferPool(size_t maxIdleBuffers, size_t maxRetainedBytesPerBuffer)
+    : maxIdleBuffers(maxIdleBuffers), maxRetainedBytesPerBuffer(maxRetainedBytesPerBuffer) {
+    idleBuffers.reserve(maxIdleBuffers);
+}
+
+BufferPool::Lease BufferPool::acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idleBuffers.empty()) {
+        return Lease(this, std::vector<char>());
+    }
+
+    // Hand out the largest idle buffer first, it is the most likely to fit.
+    size_t best = 0;
+    for (size_t i = 1; i < idleBuffers.size(); ++i) {
+        if (idleBuffers[i].capacity() > idleBuffers[best].capacity()) {
+            best = i;
+        }
+    }
+
+    std::vector<char> buffer = std::move(idleBuffers[best]);
+    idleBuffers.erase(idleBuffers.begin() + best);
+    return Lease(this, std::move(buffer));
+}
+
+void BufferPool::release(std::vector<char>&& buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (buffer.capacity() == 0 ||
+        buffer.capacity() > maxRetainedBytesPerBuffer ||
+        idleBuffers.size() >= maxIdleBuffers) {
+        std::vector<char>().swap(buffer);
+        return;
+    }
+
+    // Keep the size as well as the capacity: a later resize() to a size we
+    // have already reached then skips zero-filling the buffer again.
+    idleBuffers.push_back(std::move(buffer));
+}
+
+size_t BufferPool::retainedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t total = 0;
+    for (const auto& buffer : idleBuffers) {
+        total += buffer.capacity();
+    }
+    return total;
+}
+
+void BufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    idleBuffers.clear();
+    idleBuffers.shrink_to_fit();
+}
+
+BufferPool& getDecompressionBufferPool() {
+    thread_local BufferPool pool(kMaxIdleDecompressionBuffers, kMaxRetainedDecompressionBytes);
+    return pool;
+}
@@ -0,0 +1,983 @@
+#include "parser/combat_analyzers.h"
+#include "parser/boon_strip_tracker.h"
+#include "parser/event_pipeline.h"
+#include "parser/guid.h"
+#include "parser/statistics_helper.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+    // Events further in than this are taken as clock glitches when working
+    // out the recording duration.
+    constexpr uint64_t kMaxReasonableRecordingTimeMs = 7ULL * 24ULL * 60ULL * 60ULL * 1000ULL;
+
+    /**
+     * @brief Log and combat times, the POV agent, team IDs and team colors.
+     */
+    class LogMetadataAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds = eventKindBit(EventKind::Any) | eventKindBit(EventKind::StateChange);
+
+        LogMetadataAnalyzer(std::unordered_map<uint64_t, Agent>& agentsByAddress, ParsedData& result)
+            : agentsByAddress(agentsByAddress), result(result) {
+            result.combatStartTime = UINT64_MAX;
+            result.combatEndTime = 0;
+        }
+
+        void onEvent(EventTag<EventKind::Any>, const CombatEvent& event) {
+            earliestTime = std::min(earliestTime, event.time);
+            latestTime = std::max(latestTime, event.time);
+            if (event.time < kMaxReasonableRecordingTimeMs) {
+                earliestValidRecordingTime = std::min(earliestValidRecordingTime, event.time);
+                latestValidRecordingTime = std::max(latestValidRecordingTime, event.time);
+            }
+        }
+
+        void onEvent(EventTag<EventKind::StateChange>, const CombatEvent& event) {
+            switch (static_cast<StateChange>(event.isStateChange)) {
+            case StateChange::LogStart:
+                logStartTime = event.time;
+                if (logStartUnix == 0 && event.value != 0 && event.buffDmg != 0)
+                    logStartUnix = static_cast<uint32_t>(event.value);
+                break;
+            case StateChange::LogEnd:
+                logEndTime = event.time;
+                if (event.value != 0 && event.buffDmg != 0)
+                    logEndUnix = static_cast<uint32_t>(event.value);
+                break;
+            case StateChange::EnterCombat:
+                result.combatStartTime = std::min(result.combatStartTime, event.time);
+                break;
+            case StateChange::ExitCombat:
+                result.combatEndTime = std::max(result.combatEndTime, event.time);
+                break;
+            case StateChange::PointOfView:
+                povAgentID = event.srcAgent;
+                break;
+            case StateChange::IdToGuid:
+                // Auto-detect WvW team colors from stable GUIDs
+                if (event.skillId != 0) {
+                    if (const char* color = findTeamColor(Guid128::fromIdToGuid(event)))
+                        result.logTeamNames[event.skillId] = color;
+                }
+                break;
+            case StateChange::TeamChange: {
+                uint32_t teamID = static_cast<uint32_t>(event.value);
+                auto agentIt = agentsByAddress.find(event.srcAgent);
+                if (teamID != 0 && agentIt != agentsByAddress.end()) {
+                    agentIt->second.teamID = teamID;
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        void finish(const ParserSettingsSnapshot& settings) {
+            // Stats are keyed by the raw ID; names are only for logging here and
+            // are resolved again whenever the log is shown. The GUID events
+            // can come after the team changes, so naming waits for the end.
+            for (auto& [_, agent] : agentsByAddress) {
+                if (agent.teamID == 0) {
+                    continue;
+                }
+                std::string teamName = resolveTeamName(agent.teamID, result.logTeamNames, settings.teamIDs);
+
+                if (settings.debugStringsMode) {
+                    std::string agentInfo = agent.name.empty() ? agent.accountName : agent.name;
+                    if (agentInfo.empty()) agentInfo = "Unknown Agent";
+                    if (!teamName.empty()) {
+                        APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+                            ("TeamChange: Agent '" + agentInfo + "' assigned to team ID " +
+                            std::to_string(agent.teamID) + " (" + teamName + ")").c_str());
+                    } else {
+                        APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+                            ("TeamChange: Agent '" + agentInfo + "' has UNKNOWN team ID " +
+                            std::to_string(agent.teamID) + " (not in GUID map or settings)").c_str());
+                    }
+                }
+
+                if (!teamName.empty()) {
+                    agent.team = teamName;
+                }
+            }
+
+            // Set POV team
+            auto povIt = agentsByAddress.find(povAgentID);
+            if (povIt != agentsByAddress.end()) {
+                Agent& povAgent = povIt->second;
+                if (povAgent.teamID != 0) {
+                    result.teamStatsById[povAgent.teamID].isPOVTeam = true;
+                    APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+                        ("POV Agent Team: " + std::to_string(povAgent.teamID) + " (" + povAgent.team + ")").c_str());
+                }
+                else {
+                    APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+                        ("POV Agent's team is unknown - AgentID: " + std::to_string(povAgentID)).c_str());
+                }
+            }
+
+            // Set combat times
+            if (result.combatStartTime == UINT64_MAX) {
+                result.combatStartTime = (logStartTime != UINT64_MAX) ? logStartTime : earliestTime;
+            }
+            if (result.combatEndTime == 0) {
+                result.combatEndTime = (logEndTime != 0) ? logEndTime : latestTime;
+            }
+
+            uint64_t recordingDurationSeconds = 0;
+            if (earliestValidRecordingTime != UINT64_MAX && latestValidRecordingTime >= earliestValidRecordingTime) {
+                recordingDurationSeconds = (latestValidRecordingTime - earliestValidRecordingTime + 500) / 1000;
+            }
+
+            if (logStartUnix == 0 && logEndUnix != 0) {
+                logStartUnix = logEndUnix > recordingDurationSeconds
+                    ? logEndUnix - recordingDurationSeconds
+                    : 0;
+            }
+            else if (logEndUnix == 0 && logStartUnix != 0) {
+                logEndUnix = logStartUnix + recordingDurationSeconds;
+            }
+
+            if (logStartUnix != 0 && logEndUnix != 0 && logEndUnix < logStartUnix) {
+                logEndUnix = logStartUnix + recordingDurationSeconds;
+            }
+
+            result.logStartUnix = logStartUnix;
+            result.logEndUnix = logEndUnix;
+        }
+
+    private:
+        std::unordered_map<uint64_t, Agent>& agentsByAddress;
+        ParsedData& result;
+        uint64_t logStartTime = UINT64_MAX;
+        uint64_t logEndTime = 0;
+        uint64_t logStartUnix = 0;
+        uint64_t logEndUnix = 0;
+        uint64_t earliestTime = UINT64_MAX;
+        uint64_t latestTime = 0;
+        uint64_t earliestValidRecordingTime = UINT64_MAX;
+        uint64_t latestValidRecordingTime = 0;
+        uint64_t povAgentID = 0;
+    };
+
+    /**
+     * @brief Which agents took part and under which instance IDs.
+     */
+    class AgentPresenceAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds = eventKindBit(EventKind::Any);
+
+        AgentPresenceAnalyzer(std::unordered_map<uint64_t, Agent>& agentsByAddress,
+            std::unordered_map<uint16_t, Agent*>& playersBySrcInstid, LogPassResult& pass)
+            : agentsByAddress(agentsByAddress), playersBySrcInstid(playersBySrcInstid), pass(pass) {}
+
+        void onEvent(EventTag<EventKind::Any>, const CombatEvent& event) {
+            auto srcIt = agentsByAddress.find(event.srcAgent);
+            auto dstIt = agentsByAddress.find(event.dstAgent);
+
+            if (srcIt != agentsByAddress.end() && event.srcAgent != 0 && event.srcInstid != 0) {
+                pass.instidByAddress.emplace(event.srcAgent, event.srcInstid);
+            }
+            if (dstIt != agentsByAddress.end() && event.dstAgent != 0 && event.dstInstid != 0) {
+                pass.instidByAddress.emplace(event.dstAgent, event.dstInstid);
+            }
+
+            if (event.isStateChange != static_cast<uint8_t>(StateChange::None)) {
+                return;
+            }
+            if (srcIt != agentsByAddress.end()) {
+                pass.activeAddresses.insert(event.srcAgent);
+                Agent& agent = srcIt->second;
+                agent.id = event.srcInstid;
+                pass.agentsByInstid[event.srcInstid] = &agent;
+                playersBySrcInstid[event.srcInstid] = &agent;
+            }
+            if (dstIt != agentsByAddress.end()) {
+                Agent& agent = dstIt->second;
+                agent.id = event.dstInstid;
+                pass.agentsByInstid[event.dstInstid] = &agent;
+            }
+        }
+
+    private:
+        std::unordered_map<uint64_t, Agent>& agentsByAddress;
+        std::unordered_map<uint16_t, Agent*>& playersBySrcInstid;
+        LogPassResult& pass;
+    };
+
+    // A presence known only from events ends once the agent goes this long
+    // without one.
+    constexpr uint64_t kPresenceGapMs = 10000;
+
+    /**
+     * @brief When each player was in the fight, for the presence timelines.
+     *
+     * A Spawn or EnterCombat starts an agent's presence and a Despawn or
+     * ExitCombat ends it. Any event the agent deals or takes, or its own
+     * downs, ups and deaths, also start one, so players already there when
+     * the log began count too; such a presence ends at the agent's last event.
+     */
+    class PlayerPresenceAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds = eventKindBit(EventKind::Any) | eventKindBit(EventKind::StateChange);
+
+        explicit PlayerPresenceAnalyzer(const std::unordered_map<uint64_t, Agent>& agentsByAddress)
+            : agentsByAddress(agentsByAddress) {
+            presenceByAddress.reserve(agentsByAddress.size());
+            for (const auto& [address, _] : agentsByAddress) {
+                presenceByAddress.try_emplace(address);
+            }
+        }
+
+        void onEvent(EventTag<EventKind::Any>, const CombatEvent& event) {
+            if (event.isStateChange != static_cast<uint8_t>(StateChange::None)) {
+                return;
+            }
+            if (AgentPresence* presence = find(event.srcAgent)) {
+                markSeen(*presence, event.time);
+            }
+            if (AgentPresence* presence = find(event.dstAgent)) {
+                markSeen(*presence, event.time);
+            }
+        }
+
+        void onEvent(EventTag<EventKind::StateChange>, const CombatEvent& event) {
+            AgentPresence* presence = find(event.srcAgent);
+            if (!presence) {
+                return;
+            }
+            switch (static_cast<StateChange>(event.isStateChange)) {
+            case StateChange::Spawn:
+            case StateChange::EnterCombat:
+                markSeen(*presence, event.time);
+                presence->held = true;
+                break;
+            case StateChange::Despawn:
+            case StateChange::ExitCombat:
+                if (presence->open) {
+                    close(*presence, event.time);
+                }
+                break;
+            case StateChange::ChangeDown:
+            case StateChange::ChangeUp:
+            case StateChange::ChangeDead:
+                markSeen(*presence, event.time);
+                break;
+            default:
+                break;
+            }
+        }
+
+        // Needs the combat times, team IDs and POV team flag from the
+        // metadata analyzer.
+        void finish(ParsedData& result, const ParserSettingsSnapshot& settings) {
+            const uint64_t combatStart = result.combatStartTime;
+            const uint64_t combatEnd = std::max(result.combatEndTime, combatStart);
+            const size_t bucketCount = TeamTimeline::getBucketCount(combatStart, combatEnd);
+
+            // Per team, +1 in the first second of each presence and -1 after its last
+            std::unordered_map<uint32_t, std::vector<int32_t>> deltasByTeam;
+            std::unordered_map<uint32_t, uint64_t> presenceMsByTeam;
+            std::unordered_map<uint32_t, uint64_t> squadPresenceMsByTeam;
+            for (auto& [address, presence] : presenceByAddress) {
+                if (presence.open) {
+                    close(presence, presence.held ? combatEnd : presence.lastSeen);
+                }
+                const Agent& agent = agentsByAddress.at(address);
+                if (agent.teamID == 0 || presence.intervals.empty()) {
+                    continue;
+                }
+
+                auto teamIt = result.teamStatsById.find(agent.teamID);
+                bool inSquad = teamIt != result.teamStatsById.end() && teamIt->second.isPOVTeam &&
+                    agent.subgroupNumber > 0;
+                for (auto [start, end] : presence.intervals) {
+                    start = std::max(start, combatStart);
+                    end = std::min(end, combatEnd);
+                    if (start > end) {
+                        continue;
+                    }
+                    std::vector<int32_t>& deltas = deltasByTeam[agent.teamID];
+                    if (deltas.empty()) {
+                        deltas.resize(bucketCount + 1);
+                    }
+                    deltas[TeamTimeline::getBucket(start, combatStart, bucketCount)]++;
+                    deltas[TeamTimeline::getBucket(end, combatStart, bucketCount) + 1]--;
+                    presenceMsByTeam[agent.teamID] += end - start;
+                    if (inSquad) {
+                        squadPresenceMsByTeam[agent.teamID] += end - start;
+                    }
+                }
+            }
+
+            const double combatMs = static_cast<double>(combatEnd - combatStart);
+            for (const auto& [teamId, deltas] : deltasByTeam) {
+                TeamStats& team = result.teamStatsById[teamId];
+                if (team.timeline.empty()) {
+                    team.timeline.resize(bucketCount);
+                }
+                int32_t present = 0;
+                for (size_t i = 0; i < bucketCount; ++i) {
+                    present += deltas[i];
+                    team.timeline.players[i] = static_cast<uint16_t>(std::clamp<int32_t>(present, 0, UINT16_MAX));
+                }
+                if (combatMs > 0.0) {
+                    team.timeWeightedPlayers = static_cast<float>(presenceMsByTeam[teamId] / combatMs);
+                    team.squadStats.timeWeightedPlayers = static_cast<float>(squadPresenceMsByTeam[teamId] / combatMs);
+                }
+
+                if (settings.debugStringsMode) {
+                    APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+                        ("Presence: team=" + std::to_string(teamId) +
+                        " peak=" + std::to_string(team.timeline.getPeakPlayers()) +
+                        " average=" + std::to_string(team.timeWeightedPlayers)).c_str());
+                }
+            }
+        }
+
+    private:
+        struct AgentPresence {
+            std::vector<std::pair<uint64_t, uint64_t>> intervals;
+            uint64_t start = 0;
+            uint64_t lastSeen = 0;
+            bool open = false;
+            // Started by a Spawn or EnterCombat, so it lasts until a
+            // Despawn or ExitCombat however quiet the agent is
+            bool held = false;
+        };
+
+        AgentPresence* find(uint64_t address) {
+            if (address == 0) {
+                return nullptr;
+            }
+            auto it = presenceByAddress.find(address);
+            return it != presenceByAddress.end() ? &it->second : nullptr;
+        }
+
+        void markSeen(AgentPresence& presence, uint64_t time) {
+            if (presence.open && !presence.held && time > presence.lastSeen + kPresenceGapMs) {
+                close(presence, presence.lastSeen);
+            }
+            if (!presence.open) {
+                presence.open = true;
+                presence.start = time;
+                presence.lastSeen = time;
+            }
+            presence.lastSeen = std::max(presence.lastSeen, time);
+        }
+
+        static void close(AgentPresence& presence, uint64_t time) {
+            presence.intervals.emplace_back(presence.start, std::max(time, presence.start));
+            presence.open = false;
+            presence.held = false;
+        }
+
+        const std::unordered_map<uint64_t, Agent>& agentsByAddress;
+        std::unordered_map<uint64_t, AgentPresence> presenceByAddress;
+    };
+
+    /**
+     * @brief Each player's downs, ups, deaths and health, for the contribution checks.
+     *
+     * Only players are tracked: the checks only ever look up the target of
+     * player-vs-player damage.
+     */
+    class AgentStateAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds = eventKindBit(EventKind::StateChange);
+
+        AgentStateAnalyzer(const std::unordered_map<uint64_t, Agent>& agentsByAddress,
+            std::unordered_map<uint64_t, AgentState>& agentStates)
+            : agentsByAddress(agentsByAddress), agentStates(agentStates) {
+            agentStates.reserve(agentsByAddress.size());
+        }
+
+        void onEvent(EventTag<EventKind::StateChange>, const CombatEvent& event) {
+            AgentStateRecord record;
+            record.time = event.time;
+            switch (static_cast<StateChange>(event.isStateChange)) {
+            case StateChange::ChangeDown:
+                record.kind = AgentStateKind::Down;
+                break;
+            case StateChange::ChangeUp:
+                record.kind = AgentStateKind::Up;
+                break;
+            case StateChange::ChangeDead:
+                record.kind = AgentStateKind::Dead;
+                break;
+            case StateChange::HealthUpdate:
+                if (event.value <= 0) {
+                    return;
+                }
+                record.kind = AgentStateKind::Health;
+                // Rounded up, so "above 98%" stays exactly the old float
+                // test: ceil(x) > 980 holds just when x > 980.
+                record.healthPermille = static_cast<uint16_t>(std::min<uint64_t>(
+                    (event.dstAgent * 1000 + static_cast<uint64_t>(event.value) - 1) / static_cast<uint64_t>(event.value),
+                    UINT16_MAX));
+                break;
+            default:
+                return;
+            }
+
+            if (agentsByAddress.find(event.srcAgent) == agentsByAddress.end()) {
+                return;
+            }
+            agentStates[event.srcAgent].records.push_back(record);
+        }
+
+        void finish() {
+            for (auto& [_, state] : agentStates) {
+                // arcdps writes events in time order, so this is normally one pass.
+                auto byTime = [](const AgentStateRecord& a, const AgentStateRecord& b) { return a.time < b.time; };
+                if (!std::is_sorted(state.records.begin(), state.records.end(), byTime)) {
+                    std::stable_sort(state.records.begin(), state.records.end(), byTime);
+                }
+
+                // Down intervals for quick filtering
+                bool downed = false;
+                for (const auto& record : state.records) {
+                    if (record.kind == AgentStateKind::Down) {
+                        state.downIntervals.emplace_back(record.time, UINT64_MAX);
+                        downed = true;
+                    }
+                    else if (downed && (record.kind == AgentStateKind::Up || record.kind == AgentStateKind::Dead)) {
+                        state.downIntervals.back().second = record.time;
+                        downed = false;
+                    }
+                }
+            }
+        }
+
+    private:
+        const std::unordered_map<uint64_t, Agent>& agentsByAddress;
+        std::unordered_map<uint64_t, AgentState>& agentStates;
+    };
+
+    // An agent's spec rows in the fight range index; squadSpec is null
+    // outside the POV squad, as in StatBlocks.
+    struct RangeRows {
+        SpecCounters* spec = nullptr;
+        SpecCounters* squadSpec = nullptr;
+    };
+
+    struct AgentBlocks {
+        StatBlocks stats;
+        RangeRows rows;
+    };
+
+    // The stats one chunk of the stats pass adds into, with each agent's
+    // counter blocks looked up on its first event. A team's timeline and a
+    // spec's range rows are sized when first touched, so the analyzers index
+    // them freely.
+    class ChunkStats {
+    public:
+        ChunkStats(const AccumulationContext& context, std::unordered_map<uint32_t, TeamStats>& teamStatsById,
+            FightRangeIndex& rangeIndex, PlayerCounters& players, SkillCounters& skills)
+            : context(context), teamStatsById(teamStatsById), rangeIndex(rangeIndex), players(players),
+              skills(skills) {}
+
+        TeamStats& getTeam(uint32_t teamId) {
+            TeamStats& team = teamStatsById[teamId];
+            prepareTimeline(team);
+            return team;
+        }
+
+        const AgentBlocks& getBlocks(const Agent& agent) {
+            auto [it, inserted] = blocksByAgent.try_emplace(&agent);
+            if (inserted) {
+                AgentBlocks& blocks = it->second;
+                blocks.stats = resolveStatBlocks(teamStatsById[agent.teamID], agent);
+                prepareTimeline(*blocks.stats.team);
+
+                FightRangeIndex::Team& rangeTeam = rangeIndex.teams[agent.teamID];
+                blocks.rows.spec = prepareRows(rangeTeam.totals.specs[agent.eliteSpec]);
+                if (blocks.stats.squad) {
+                    blocks.rows.squadSpec = prepareRows(rangeTeam.povSquad.specs[agent.eliteSpec]);
+                }
+            }
+            return it->second;
+        }
+
+        // The range index series of a team's or POV squad's deaths from killing blows
+        uint32_t* getKillingBlowDeaths(uint32_t teamId, bool povSquad) {
+            FightRangeIndex::Team& rangeTeam = rangeIndex.teams[teamId];
+            return prepareRows((povSquad ? rangeTeam.povSquad : rangeTeam.totals).deathsFromKillingBlows);
+        }
+
+        uint64_t& getPlayerCounter(const Agent& agent, PlayerStat stat) {
+            return players.column(stat)[agent.playerRow];
+        }
+
+        // The per-skill counter cell of an agent's group, or SIZE_MAX if the
+        // log's skill table does not list the skill
+        size_t getSkillCell(const Agent& agent, uint32_t skillId) const {
+            uint16_t skill = context.skills.getDenseIndex(skillId);
+            if (skill == LogSkillTable::kNoSkill) {
+                return SIZE_MAX;
+            }
+            return context.skillGroupByPlayerRow[agent.playerRow] * skills.skillCount + skill;
+        }
+
+        void addSkillDamage(const Agent& agent, uint32_t skillId, uint64_t damage, bool vsPlayer) {
+            size_t cell = getSkillCell(agent, skillId);
+            if (cell != SIZE_MAX) {
+                skills.damage[cell] += damage;
+                if (vsPlayer) {
+                    skills.damageVsPlayers[cell] += damage;
+                }
+            }
+        }
+
+        void addSkillStrip(const Agent& agent, uint32_t skillId) {
+            size_t cell = getSkillCell(agent, skillId);
+            if (cell != SIZE_MAX) {
+                skills.strips[cell]++;
+            }
+        }
+
+        size_t getBucket(uint64_t time) const {
+            return TeamTimeline::getBucket(time, context.combatStartTime, context.timelineBuckets);
+        }
+
+        // Events of a range bucket go in the row after it; see FightRangeIndex.
+        size_t getRangeRow(uint64_t time) const {
+            return rangeIndex.getBucket(time) + 1;
+        }
+
+    private:
+        void prepareTimeline(TeamStats& team) const {
+            if (team.timeline.empty()) {
+                team.timeline.resize(context.timelineBuckets);
+            }
+        }
+
+        template <typename T>
+        T* prepareRows(std::vector<T>& rows) const {
+            if (rows.empty()) {
+                rows.resize(rangeIndex.bucketCount + 1);
+            }
+            return rows.data();
+        }
+
+        const AccumulationContext& context;
+        std::unordered_map<uint32_t, TeamStats>& teamStatsById;
+        FightRangeIndex& rangeIndex;
+        PlayerCounters& players;
+        SkillCounters& skills;
+        std::unordered_map<const Agent*, AgentBlocks> blocksByAgent;
+    };
+
+    // Adds one event into an agent's range rows, as recordStatEvent does
+    // into its counter blocks.
+    template <StatEvent Kind>
+    void recordRangeEvent(const RangeRows& rows, size_t row, uint32_t value, bool vsPlayer,
+        bool isDownedContribution = false, bool isKillContribution = false) {
+        auto add = [&](SpecCounters& counters) {
+            vsPlayer
+                ? addStatEvent<Kind, true>(counters, value, isDownedContribution, isKillContribution)
+                : addStatEvent<Kind, false>(counters, value, isDownedContribution, isKillContribution);
+        };
+        add(rows.spec[row]);
+        if (rows.squadSpec) {
+            add(rows.squadSpec[row]);
+        }
+    }
+
+    // Looks up a player on a team by instance ID, or returns null.
+    const Agent* findTeamAgent(const std::unordered_map<uint16_t, Agent*>& agents, uint16_t instid) {
+        auto it = agents.find(instid);
+        return it != agents.end() && it->second->teamID != 0 ? it->second : nullptr;
+    }
+
+    class DeathDownAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds = eventKindBit(EventKind::StateChange);
+
+        DeathDownAnalyzer(const AccumulationContext& context, ChunkStats& stats)
+            : context(context), stats(stats) {}
+
+        void onEvent(EventTag<EventKind::StateChange>, const CombatEvent& event) {
+            StateChange stateChange = static_cast<StateChange>(event.isStateChange);
+            if (stateChange != StateChange::ChangeDead && stateChange != StateChange::ChangeDown) {
+                return;
+            }
+            const Agent* agent = findTeamAgent(context.agentsByInstid, event.srcInstid);
+            if (!agent) {
+                return;
+            }
+
+            const AgentBlocks& agentBlocks = stats.getBlocks(*agent);
+            const StatBlocks& blocks = agentBlocks.stats;
+            const RangeRows& rows = agentBlocks.rows;
+            size_t bucket = stats.getBucket(event.time);
+            size_t row = stats.getRangeRow(event.time);
+            if (stateChange == StateChange::ChangeDead) {
+                blocks.team->timeline.deaths[bucket]++;
+                stats.getPlayerCounter(*agent, PlayerStat::Deaths)++;
+                blocks.team->totalDeaths++;
+                blocks.spec->totalDeaths++;
+                rows.spec[row].totalDeaths++;
+                if (blocks.squad) {
+                    blocks.squad->totalDeaths++;
+                    blocks.squadSpec->totalDeaths++;
+                    rows.squadSpec[row].totalDeaths++;
+                    if (blocks.subgroup) {
+                        blocks.subgroup->totalDeaths++;
+                    }
+                }
+            }
+            else {
+                blocks.team->timeline.downs[bucket]++;
+                stats.getPlayerCounter(*agent, PlayerStat::Downs)++;
+                blocks.team->totalDowned++;
+                blocks.spec->totalDowned++;
+                rows.spec[row].totalDowned++;
+                if (blocks.squad) {
+                    blocks.squad->totalDowned++;
+                    blocks.squadSpec->totalDowned++;
+                    rows.squadSpec[row].totalDowned++;
+                    if (blocks.subgroup) {
+                        blocks.subgroup->totalDowned++;
+                    }
+                }
+            }
+        }
+
+    private:
+        const AccumulationContext& context;
+        ChunkStats& stats;
+    };
+
+    class DamageAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds =
+            eventKindBit(EventKind::StrikeDamage) | eventKindBit(EventKind::CondiDamage);
+
+        DamageAnalyzer(const AccumulationContext& context, ChunkStats& stats)
+            : context(context), stats(stats) {}
+
+        void onEvent(EventTag<EventKind::StrikeDamage>, const CombatEvent& event) {
+            addDamage<StatEvent::StrikeDamage>(event, event.value);
+        }
+
+        void onEvent(EventTag<EventKind::CondiDamage>, const CombatEvent& event) {
+            addDamage<StatEvent::CondiDamage>(event, event.buffDmg);
+        }
+
+    private:
+        template <StatEvent Kind>
+        void addDamage(const CombatEvent& event, int32_t damageValue) {
+            if (damageValue <= 0) {
+                return;
+            }
+            const Agent* attacker = findTeamAgent(context.playersBySrcInstid, event.srcInstid);
+            if (!attacker) {
+                return;
+            }
+
+            bool vsPlayer = false;
+            bool isDownedContribution = false;
+            bool isKillContribution = false;
+            if (const Agent* target = findTeamAgent(context.agentsByInstid, event.dstInstid)) {
+                vsPlayer = true;
+                auto stateIt = context.agentStates.find(target->address);
+                if (stateIt != context.agentStates.end()) {
+                    isDownedContribution = isDamageInDownSequence(target, stateIt->second, event.time);
+                    isKillContribution = isDamageInKillSequence(target, stateIt->second, event.time);
+                }
+            }
+
+            const AgentBlocks& blocks = stats.getBlocks(*attacker);
+            recordStatEvent<Kind>(blocks.stats, static_cast<uint64_t>(damageValue), vsPlayer,
+                isDownedContribution, isKillContribution);
+            recordRangeEvent<Kind>(blocks.rows, stats.getRangeRow(event.time), static_cast<uint32_t>(damageValue),
+                vsPlayer, isDownedContribution, isKillContribution);
+
+            TeamTimeline& timeline = blocks.stats.team->timeline;
+            size_t bucket = stats.getBucket(event.time);
+            timeline.damage[bucket] += static_cast<uint32_t>(damageValue);
+            if (vsPlayer) {
+                timeline.damageVsPlayers[bucket] += static_cast<uint32_t>(damageValue);
+            }
+
+            const uint64_t damage = static_cast<uint64_t>(damageValue);
+            stats.addSkillDamage(*attacker, event.skillId, damage, vsPlayer);
+            stats.getPlayerCounter(*attacker, PlayerStat::Damage) += damage;
+            if (vsPlayer) {
+                stats.getPlayerCounter(*attacker, PlayerStat::DamageVsPlayers) += damage;
+            }
+            if (isDownedContribution) {
+                stats.getPlayerCounter(*attacker, PlayerStat::DownedContribution) += damage;
+            }
+            if (isKillContribution) {
+                stats.getPlayerCounter(*attacker, PlayerStat::KillContribution) += damage;
+            }
+        }
+
+        const AccumulationContext& context;
+        ChunkStats& stats;
+    };
+
+    // Counts strips and attributes each to the boon strip skill the stripper
+    // had just cast, if any.
+    class StripAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds = eventKindBit(EventKind::Strip) | eventKindBit(EventKind::Activation);
+
+        StripAnalyzer(const AccumulationContext& context, ChunkStats& stats)
+            : context(context), stats(stats) {}
+
+        // Tracks the casts in the window before event begin, so a chunk's
+        // first strips find casts made at the end of the chunk before it
+        void replayActivationsBefore(size_t begin) {
+            if (begin == 0 || begin >= context.events.size()) {
+                return;
+            }
+            const std::vector<uint32_t>& casts = context.streams.activations;
+            const uint64_t startTime = context.events[begin].time;
+            auto last = std::lower_bound(casts.begin(), casts.end(), begin);
+            auto first = last;
+            while (first != casts.begin() &&
+                context.events[*(first - 1)].time + BoonStripTracker::kDefaultWindowMs >= startTime) {
+                --first;
+            }
+            for (; first != last; ++first) {
+                onEvent(EventTag<EventKind::Activation>{}, context.events[*first]);
+            }
+        }
+
+        void onEvent(EventTag<EventKind::Activation>, const CombatEvent& event) {
+            tracker.trackSkillActivation(event.srcInstid, event.skillId, event.time);
+        }
+
+        void onEvent(EventTag<EventKind::Strip>, const CombatEvent& event) {
+            // Skip if destination agent is 0 (unknown) - since dst is now our stripper
+            if (event.dstAgent == 0) {
+                return;
+            }
+            // Skip if it's a self-strip
+            if (event.srcInstid == event.dstInstid) {
+                return;
+            }
+            // Skip if overstackValue (RemovedDuration) is 0
+            if (event.value == 0) {
+                return;
+            }
+            // Only count removals of specific boons
+            if (!isTrackedBoon(event.skillId)) {
+                return;
+            }
+
+            // The destination agent is the stripper and the source the target
+            const Agent* stripper = findTeamAgent(context.playersBySrcInstid, event.dstInstid);
+            if (!stripper) {
+                return;
+            }
+            bool vsPlayer = findTeamAgent(context.agentsByInstid, event.srcInstid) != nullptr;
+            const AgentBlocks& blocks = stats.getBlocks(*stripper);
+            recordStatEvent<StatEvent::Strip>(blocks.stats, 0, vsPlayer);
+            recordRangeEvent<StatEvent::Strip>(blocks.rows, stats.getRangeRow(event.time), 0, vsPlayer);
+            blocks.stats.team->timeline.strips[stats.getBucket(event.time)]++;
+            const uint32_t stripSkill = tracker.findRecentStripSkill(event.dstInstid, event.time);
+            blocks.stats.team->stripsBySkill[stripSkill]++;
+            if (stripSkill != 0) {
+                stats.addSkillStrip(*stripper, stripSkill);
+            }
+            stats.getPlayerCounter(*stripper, PlayerStat::Strips)++;
+            if (vsPlayer) {
+                stats.getPlayerCounter(*stripper, PlayerStat::StripsVsPlayers)++;
+            }
+        }
+
+    private:
+        const AccumulationContext& context;
+        ChunkStats& stats;
+        BoonStripTracker tracker;
+    };
+
+    class KillAnalyzer {
+    public:
+        static constexpr uint32_t kEventKinds = eventKindBit(EventKind::KillingBlow);
+
+        KillAnalyzer(const AccumulationContext& context, ChunkStats& stats)
+            : context(context), stats(stats) {}
+
+        void onEvent(EventTag<EventKind::KillingBlow>, const CombatEvent& event) {
+            const Agent* attacker = findTeamAgent(context.playersBySrcInstid, event.srcInstid);
+            if (!attacker) {
+                return;
+            }
+            const Agent* target = findTeamAgent(context.agentsByInstid, event.dstInstid);
+            if (!target) {
+                return;
+            }
+
+            size_t row = stats.getRangeRow(event.time);
+            auto& targetStats = stats.getTeam(target->teamID);
+            targetStats.totalDeathsFromKillingBlows++;
+            stats.getKillingBlowDeaths(target->teamID, false)[row]++;
+            if (targetStats.isPOVTeam && target->subgroupNumber > 0) {
+                targetStats.squadStats.totalDeathsFromKillingBlows++;
+                stats.getKillingBlowDeaths(target->teamID, true)[row]++;
+            }
+            const AgentBlocks& blocks = stats.getBlocks(*attacker);
+            recordStatEvent<StatEvent::Kill>(blocks.stats, 0, true);
+            recordRangeEvent<StatEvent::Kill>(blocks.rows, row, 0, true);
+            stats.getPlayerCounter(*attacker, PlayerStat::Kills)++;
+        }
+
+    private:
+        const AccumulationContext& context;
+        ChunkStats& stats;
+    };
+}
+
+bool runLogPass(const CombatEventView& events, const EventStreams& streams,
+    std::unordered_map<uint64_t, Agent>& agentsByAddress,
+    std::unordered_map<uint16_t, Agent*>& playersBySrcInstid,
+    ParsedData& result, LogPassResult& pass,
+    const ParserSettingsSnapshot& settings, const CancellationToken& token) {
+    LogMetadataAnalyzer metadata(agentsByAddress, result);
+    AgentPresenceAnalyzer presence(agentsByAddress, playersBySrcInstid, pass);
+    AgentStateAnalyzer agentStates(agentsByAddress, pass.agentStates);
+    PlayerPresenceAnalyzer playerPresence(agentsByAddress);
+
+    EventPipeline<LogMetadataAnalyzer, AgentPresenceAnalyzer, AgentStateAnalyzer, PlayerPresenceAnalyzer> pipeline(
+        metadata, presence, agentStates, playerPresence);
+    if (!pipeline.run(events, streams, 0, events.size(), token)) {
+        return false;
+    }
+
+    metadata.finish(settings);
+    agentStates.finish();
+    playerPresence.finish(result, settings);
+
+    if (settings.debugStringsMode) {
+        size_t recordCount = 0;
+        for (const auto& [_, state] : pass.agentStates) {
+            recordCount += state.records.size();
+        }
+        APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+            ("Agent states: " + std::to_string(pass.agentStates.size()) + " players, " +
+            std::to_string(recordCount) + " records, " +
+            std::to_string(recordCount * sizeof(AgentStateRecord) / 1024) + " KB").c_str());
+    }
+    return true;
+}
+
+void assignPlayerRows(std::unordered_map<uint64_t, Agent>& agentsByAddress, const ParsedData& result,
+    PlayerStatsTable& table) {
+    std::vector<Agent*> players;
+    for (auto& [_, agent] : agentsByAddress) {
+        if (agent.teamID != 0) {
+            players.push_back(&agent);
+        }
+    }
+    std::sort(players.begin(), players.end(), [](const Agent* a, const Agent* b) {
+        return a->teamID != b->teamID ? a->teamID < b->teamID : a->address < b->address;
+    });
+
+    table.names.reserve(players.size());
+    table.eliteSpecs.reserve(players.size());
+    table.teamIDs.reserve(players.size());
+    table.inSquad.reserve(players.size());
+    for (Agent* agent : players) {
+        agent->playerRow = static_cast<uint32_t>(table.size());
+        auto teamIt = result.teamStatsById.find(agent->teamID);
+        bool inSquad = teamIt != result.teamStatsById.end() && teamIt->second.isPOVTeam &&
+            agent->subgroupNumber > 0;
+        table.names.push_back(agent->name.empty() ? agent->accountName : agent->name);
+        table.eliteSpecs.push_back(agent->eliteSpec);
+        table.teamIDs.push_back(agent->teamID);
+        table.inSquad.push_back(inSquad ? 1 : 0);
+    }
+    table.counters.resize(table.size());
+}
+
+std::vector<uint32_t> assignSkillGroups(const PlayerStatsTable& players, SkillStatsTable& table) {
+    std::vector<uint32_t> groupByRow(players.size());
+    for (uint32_t row = 0; row < players.size(); ++row) {
+        const bool inSquad = players.inSquad[row] != 0;
+        auto it = std::find_if(table.groups.begin(), table.groups.end(), [&](const SkillStatsTable::Group& group) {
+            return group.teamID == players.teamIDs[row] && group.inSquad == inSquad &&
+                group.eliteSpec == players.eliteSpecs[row];
+        });
+        if (it == table.groups.end()) {
+            SkillStatsTable::Group group;
+            group.teamID = players.teamIDs[row];
+            group.eliteSpec = players.eliteSpecs[row];
+            group.inSquad = inSquad;
+            it = table.groups.insert(table.groups.end(), std::move(group));
+        }
+        groupByRow[row] = static_cast<uint32_t>(it - table.groups.begin());
+    }
+    return groupByRow;
+}
+
+void accumulateEventRange(const AccumulationContext& context, size_t begin, size_t end,
+    std::unordered_map<uint32_t, TeamStats>& teamStatsById, FightRangeIndex& rangeIndex,
+    PlayerCounters& players, SkillCounters& skills, const CancellationToken& token) {
+    ChunkStats stats(context, teamStatsById, rangeIndex, players, skills);
+    DeathDownAnalyzer deathsAndDowns(context, stats);
+    DamageAnalyzer damage(context, stats);
+    StripAnalyzer strips(context, stats);
+    KillAnalyzer kills(context, stats);
+    strips.replayActivationsBefore(begin);
+
+    EventPipeline<DeathDownAnalyzer, DamageAnalyzer, StripAnalyzer, KillAnalyzer> pipeline(
+        deathsAndDowns, damage, strips, kills);
+    pipeline.run(context.events, context.streams, begin, end, token);
+}
+
+void countPlayers(const std::unordered_map<uint64_t, Agent>& agentsByAddress, const LogPassResult& pass,
+    ParsedData& result, const ParserSettingsSnapshot& settings) {
+    std::unordered_map<uint32_t, std::unordered_set<std::string>> countedAccounts;
+    std::unordered_set<uint16_t> countedNonSquadInstids;
+
+    for (const auto& [addr, agent] : agentsByAddress) {
+        if (agent.teamID == 0) continue;
+
+        bool isSquad = agent.subgroupNumber > 0;
+
+        if (isSquad) {
+            if (!pass.activeAddresses.count(addr)) continue;
+            if (!agent.accountName.empty() && agent.accountName[0] == ':') {
+                if (!countedAccounts[agent.teamID].insert(agent.accountName).second)
+                    continue;
+            }
+        } else {
+            auto iit = pass.instidByAddress.find(addr);
+            if (iit == pass.instidByAddress.end()) continue;
+            if (!countedNonSquadInstids.insert(iit->second).second)
+                continue;
+        }
+
+        auto& teamStats = result.teamStatsById[agent.teamID];
+        auto& specStats = teamStats.eliteSpecStats[agent.eliteSpec];
+
+        teamStats.totalPlayers++;
+        specStats.count++;
+
+        if (settings.debugStringsMode) {
+            APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+                ("COUNT: addr=" + std::to_string(addr) +
+                 " squad=" + std::to_string(isSquad) +
+                 " team=" + std::to_string(agent.teamID) +
+                 " spec=" + agent.eliteSpec +
+                 " total=" + std::to_string(teamStats.totalPlayers)).c_str());
+        }
+
+        if (teamStats.isPOVTeam && isSquad) {
+            auto& squadStats = teamStats.squadStats;
+            squadStats.totalPlayers++;
+            squadStats.eliteSpecStats[agent.eliteSpec].count++;
+            if (agent.subgroupNumber <= static_cast<int>(kMaxSubgroups)) {
+                squadStats.subgroupStats[agent.subgroupNumber - 1].count++;
+            }
+        }
+    }
+}
@@ -0,0 +1,226 @@
+#include "parser/directory_index.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace {
+    constexpr int kIndexFormatVersion = 1;
+}
+
+std::wstring DirectoryIndex::makeKey(const std::filesystem::path& filePath) {
+    return filePath.lexically_normal().wstring();
+}
+
+void DirectoryIndex::setRoot(const std::filesystem::path& dirPath, Filter acceptFilter) {
+    if (makeKey(dirPath) != makeKey(root)) {
+        entries.clear();
+    }
+    root = dirPath;
+    filter = std::move(acceptFilter);
+}
+
+std::vector<DirectoryIndex::Entry> DirectoryIndex::reconcile(const CancellationToken& token) {
+    std::vector<Entry> changed;
+    std::unordered_map<std::wstring, Entry> current;
+    current.reserve(entries.size());
+
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, ec);
+        !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        // directory_entry caches size and write time from the directory
+        // listing itself, so this walk needs no per-file stat calls.
+        // Each step is a directory read, so checking every time is cheap.
+        if (token.isCancelled()) {
+            return {};
+        }
+
+        const auto& entry = *it;
+        std::error_code entryEc;
+        if (!entry.is_regular_file(entryEc)) {
+            continue;
+        }
+
+        // The filter only looks at the path, so files already indexed were
+        // accepted before and skip it.
+        std::wstring key = makeKey(entry.path());
+        auto previous = entries.find(key);
+        if (previous == entries.end() && filter && !filter(entry.path())) {
+            continue;
+        }
+
+        Entry indexed;
+        indexed.path = entry.path();
+        indexed.size = entry.file_size(entryEc);
+        indexed.lastWriteTime = entry.last_write_time(entryEc);
+        if (entryEc) {
+            continue;
+        }
+
+        if (previous == entries.end() ||
+            previous->second.size != indexed.size ||
+            previous->second.lastWriteTime != indexed.lastWriteTime) {
+            changed.push_back(indexed);
+        }
+        current.emplace(std::move(key), std::move(indexed));
+    }
+
+    if (!ec && !token.isCancelled()) {
+        entries = std::move(current);
+    }
+    return changed;
+}
+
+bool DirectoryIndex::update(const std::filesystem::path& filePath, Entry* outEntry) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(filePath, ec) || (filter && !filter(filePath))) {
+        remove(filePath);
+        return false;
+    }
+
+    Entry indexed;
+    indexed.path = filePath;
+    indexed.size = std::filesystem::file_size(filePath, ec);
+    if (ec) {
+        return false;
+    }
+    indexed.lastWriteTime = std::filesystem::last_write_time(filePath, ec);
+    if (ec) {
+        return false;
+    }
+
+    auto& slot = entries[makeKey(filePath)];
+    bool changed = slot.path.empty() || slot.size != indexed.size || slot.lastWriteTime != indexed.lastWriteTime;
+    slot = indexed;
+    if (outEntry) {
+        *outEntry = std::move(indexed);
+    }
+    return changed;
+}
+
+void DirectoryIndex::remove(const std::filesystem::path& filePath) {
+    entries.erase(makeKey(filePath));
+}
+
+std::vector<DirectoryIndex::Entry> DirectoryIndex::getFilesNewerThan(std::filesystem::file_time_type time) const {
+    std::vector<Entry> result;
+    for (const auto& [_, entry] : entries) {
+        if (entry.lastWriteTime > time) {
+            result.push_back(entry);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) {
+        return a.lastWriteTime < b.lastWriteTime;
+    });
+    return result;
+}
+
+std::vector<DirectoryIndex::Entry> DirectoryIndex::getNewestFiles(size_t count) const {
+    std::vector<Entry> result;
+    result.reserve(entries.size());
+    for (const auto& [_, entry] : entries) {
+        result.push_back(entry);
+    }
+
+    auto newerFirst = [](const Entry& a, const Entry& b) {
+        return a.lastWriteTime > b.lastWriteTime;
+    };
+    if (count < result.size()) {
+        std::partial_sort(result.begin(), result.begin() + count, result.end(), newerFirst);
+        result.resize(count);
+    }
+    else {
+        std::sort(result.begin(), result.end(), newerFirst);
+    }
+    return result;
+}
+
+size_t DirectoryIndex::getMemoryUsage() const {
+    size_t total = entries.bucket_count() * sizeof(void*);
+    for (const auto& [key, entry] : entries) {
+        total += sizeof(std::pair<const std::wstring, Entry>) + 2 * sizeof(void*);
+        total += key.capacity() * sizeof(wchar_t);
+        total += entry.path.native().capacity() * sizeof(std::filesystem::path::value_type);
+    }
+    return total;
+}
+
+bool DirectoryIndex::load(const std::filesystem::path& indexPath) {
+    try {
+        std::ifstream file(indexPath);
+        if (!file) {
+            return false;
+        }
+
+        json j = json::parse(file);
+        if (j.value("version", 0) != kIndexFormatVersion ||
+            makeKey(std::filesystem::u8path(j.value("root", std::string()))) != makeKey(root)) {
+            return false;
+        }
+
+        std::unordered_map<std::wstring, Entry> loaded;
+        for (const auto& row : j["files"]) {
+            Entry entry;
+            entry.path = root / std::filesystem::u8path(row.at(0).get<std::string>());
+            entry.size = row.at(1).get<uint64_t>();
+            entry.lastWriteTime = std::filesystem::file_time_type(
+                std::filesystem::file_time_type::duration(row.at(2).get<int64_t>()));
+            loaded.emplace(makeKey(entry.path), std::move(entry));
+        }
+
+        entries = std::move(loaded);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+bool DirectoryIndex::save(const std::filesystem::path& indexPath) const {
+    try {
+        json files = json::array();
+        for (const auto& [_, entry] : entries) {
+            files.push_back({
+                entry.path.lexically_relative(root).u8string(),
+                entry.size,
+                static_cast<int64_t>(entry.lastWriteTime.time_since_epoch().count())
+            });
+        }
+
+        json j = {
+            {"version", kIndexFormatVersion},
+            {"root", root.u8string()},
+            {"files", std::move(files)}
+        };
+
+        // Written aside and renamed over the old index, so a crash or a
+        // full disk mid-write never leaves a truncated index behind.
+        std::filesystem::path tempPath = indexPath;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::trunc);
+            if (!file) {
+                return false;
+            }
+            file << j.dump();
+            file.close();
+            if (!file) {
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, indexPath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
@@ -1,7 +1,14 @@
 #define NOMINMAX
 #include "parser/directory_monitor.h"
+#include "parser/directory_index.h"
 #include "parser/evtc_parser.h"
 #include "parser/file_helpers.h"
+#include "parser/file_watcher.h"
+#include "parser/log_history.h"
+#include "parser/log_readiness.h"
+#include "parser/parse_metrics.h"
+#include "parser/parse_pipeline.h"
+#include "parser/parse_scheduler.h"
 #include "parser/statistics_helper.h"
 #include "settings/Settings.h"
 #include "shared/Shared.h"
@@ -11,16 +18,58 @@
 #include <filesystem>
 #include <shlobj.h>
 #include <unordered_set>
+#include <unordered_map>
 #include <algorithm>
 #include <vector>
+#include <memory>
 #include <mutex>
 #include <cstring>
 
 std::unordered_set<std::wstring> processedFiles;
 std::filesystem::file_time_type maxProcessedTime = std::filesystem::file_time_type::min();
 static bool flatLogMode = false;
+static DirectoryIndex logIndex;
+static bool logIndexDirty = false;
+// Set when the index was restored from disk and has not been walked since
+static bool logIndexNeedsReconcile = false;
+// Refreshed by the monitor thread, which owns logIndex, for the options window
+static std::atomic<size_t> logIndexMemoryUsage{ 0 };
+
+// A live log seen by the watcher whose writer has not finished yet.
+struct PendingLog
+{
+	DirectoryIndex::Entry entry;
+	std::chrono::steady_clock::time_point detectedAt;
+	std::chrono::steady_clock::time_point lastSizeChange;
+};
+static std::unordered_map<std::wstring, PendingLog> pendingLogs;
+
+// Guards parsePipeline and activeWatcher, which requestStopMonitoring
+// reaches into from other threads.
+static std::mutex monitorControlMutex;
+static std::unique_ptr<ParsePipeline> parsePipeline;
+static FileWatcher* activeWatcher = nullptr;
+// Backlog logs not yet finished by the pipeline, plus one while they are
+// still being submitted; initial parsing is complete once this drops to zero.
+static std::atomic<size_t> backlogRemaining{ 0 };
+// Largest WvW log published this session, for the accumulation benchmark
+static std::mutex largestLogMutex;
+static std::filesystem::path largestLogPath;
+static uintmax_t largestLogSize = 0;
 
 static bool shouldSkipLog(const ParsedLog& log, const ParserSettingsSnapshot& settings);
+static void publishParsedLog(const LogJob& job, ParsedLog&& log);
+static void finishParsedLog(const LogJob& job);
+
+// Counts one backlog log as done, whether it was published, failed or never
+// made it into the pipeline.
+static void finishBacklogLog()
+{
+	if (backlogRemaining.fetch_sub(1) == 1)
+	{
+		initialParsingComplete = true;
+	}
+}
 
 bool isValidEVTCFile(const std::filesystem::path& dirPath, const std::filesystem::path& filePath)
 {
@@ -82,10 +131,214 @@ bool isValidEVTCFile(const std::filesystem::path& dirPath, const std::filesystem
 	return false;
 }
 
-void processEVTCFile(const std::filesystem::path& filePath)
+static std::filesystem::path getLogIndexPath()
+{
+	return AddonPath / "log_index.json";
+}
+
+// Points the index at dirPath, restoring the previous session's index when
+// it was saved for the same directory. A restored index serves the initial
+// parse as is; logs added, changed or deleted while the game was closed are
+// picked up by a reconcile on the monitor loop's first idle tick.
+static void prepareLogIndex(const std::filesystem::path& dirPath)
+{
+	logIndex.setRoot(dirPath, [dirPath](const std::filesystem::path& filePath)
+		{
+			return isEVTCLogFile(filePath) && isValidEVTCFile(dirPath, filePath);
+		});
+
+	if (logIndex.load(getLogIndexPath()))
+	{
+		logIndexNeedsReconcile = true;
+		logIndexMemoryUsage = logIndex.getMemoryUsage();
+		APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+			("Restored log index with " + std::to_string(logIndex.size()) + " files.").c_str());
+		return;
+	}
+
+	logIndex.reconcile(CancellationToken(stopMonitoring));
+	logIndexDirty = true;
+	logIndexMemoryUsage = logIndex.getMemoryUsage();
+	APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+		("Built log index with " + std::to_string(logIndex.size()) + " files.").c_str());
+}
+
+static void saveLogIndex()
+{
+	logIndexMemoryUsage = logIndex.getMemoryUsage();
+	if (logIndexDirty && logIndex.save(getLogIndexPath()))
+	{
+		logIndexDirty = false;
+	}
+}
+
+// Hands a ready log to the parse pipeline. It counts as processed from here
+// on, so later notifications for it are ignored. Returns false if the log
+// was not submitted, so the pipeline will never finish it.
+static bool processIndexedFile(const DirectoryIndex::Entry& entry, std::unordered_set<std::wstring>& processedFiles,
+	LogPriority priority, std::chrono::steady_clock::time_point detectedAt = {})
+{
+	std::wstring absolutePath = std::filesystem::absolute(entry.path).wstring();
+	if (processedFiles.find(absolutePath) != processedFiles.end())
+	{
+		return false;
+	}
+
+	if (priority == LogPriority::Live)
+	{
+		newLogDetectedTime.store(-1.0f);
+	}
+
+	LogJob job;
+	job.path = entry.path;
+	job.lastWriteTime = entry.lastWriteTime;
+	job.detectedAt = detectedAt;
+	job.priority = priority;
+
+	// Only this thread creates and destroys the pipeline, so it can be used
+	// without the lock here.
+	if (!parsePipeline || !parsePipeline->submit(std::move(job)))
+	{
+		return false;
+	}
+
+	processedFiles.insert(absolutePath);
+
+	if (entry.lastWriteTime > maxProcessedTime)
+	{
+		maxProcessedTime = entry.lastWriteTime;
+	}
+	return true;
+}
+
+static PendingLog& trackPendingLog(const DirectoryIndex::Entry& entry, std::chrono::steady_clock::time_point detectedAt)
+{
+	auto now = std::chrono::steady_clock::now();
+	auto [it, inserted] = pendingLogs.try_emplace(std::filesystem::absolute(entry.path).wstring(),
+		PendingLog{ entry, detectedAt, now });
+	if (!inserted)
+	{
+		if (it->second.entry.size != entry.size)
+		{
+			it->second.lastSizeChange = now;
+		}
+		it->second.entry = entry;
+	}
+	return it->second;
+}
+
+// The writer counts as done once the file can be opened without write
+// sharing and, for .zevtc, its zip trailer is complete. Where that cannot be
+// decided the size has to hold still instead, and after a generous timeout
+// the log is parsed regardless, as the old size polling did.
+static bool isPendingLogReady(PendingLog& pending, std::chrono::steady_clock::time_point now)
+{
+	const auto sizeStableTime = std::chrono::milliseconds(500);
+	const auto maxReadinessWait = std::chrono::seconds(15);
+
+	switch (checkLogReadiness(pending.entry.path))
+	{
+	case LogReadiness::Ready:
+		return true;
+	case LogReadiness::Unknown:
+	{
+		std::error_code ec;
+		uint64_t size = std::filesystem::file_size(pending.entry.path, ec);
+		if (ec || size != pending.entry.size)
+		{
+			pending.entry.size = ec ? 0 : size;
+			pending.lastSizeChange = now;
+		}
+		else if (size > 0 && now - pending.lastSizeChange >= sizeStableTime)
+		{
+			return true;
+		}
+		break;
+	}
+	case LogReadiness::Writing:
+		break;
+	case LogReadiness::Unreadable:
+		// Hand it on now; the pipeline reports why it cannot be loaded.
+		APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+			("Log cannot be opened, not waiting for it: " + getUtf8Path(pending.entry.path)).c_str());
+		return true;
+	}
+
+	if (now - pending.detectedAt >= maxReadinessWait)
+	{
+		APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+			("Timeout waiting for log to be written, parsing anyway: " + getUtf8Path(pending.entry.path)).c_str());
+		return true;
+	}
+	return false;
+}
+
+static void publishPendingLog(const PendingLog& pending, std::unordered_set<std::wstring>& processedFiles)
+{
+	parseMetrics.readiness.record(std::chrono::steady_clock::now() - pending.detectedAt);
+
+	// Pick up the final size and write time now that the writer is done.
+	DirectoryIndex::Entry entry = pending.entry;
+	if (logIndex.update(pending.entry.path, &entry))
+	{
+		logIndexDirty = true;
+	}
+	processIndexedFile(entry, processedFiles, LogPriority::Live, pending.detectedAt);
+}
+
+// Publishes a live log as soon as its writer is done. Until then it stays
+// pending and is rechecked on each change notification for it and on every
+// pass of the monitor loop.
+static void queueLiveLog(const DirectoryIndex::Entry& entry, std::chrono::steady_clock::time_point detectedAt,
+	std::unordered_set<std::wstring>& processedFiles)
+{
+	std::wstring absolutePath = std::filesystem::absolute(entry.path).wstring();
+	if (processedFiles.find(absolutePath) != processedFiles.end())
+	{
+		pendingLogs.erase(absolutePath);
+		return;
+	}
+
+	PendingLog& pending = trackPendingLog(entry, detectedAt);
+	if (isPendingLogReady(pending, std::chrono::steady_clock::now()))
+	{
+		PendingLog ready = std::move(pending);
+		pendingLogs.erase(absolutePath);
+		publishPendingLog(ready, processedFiles);
+	}
+}
+
+static void checkPendingLogs(std::unordered_set<std::wstring>& processedFiles)
 {
-	waitForFile(filePath);
-	processNewEVTCFile(filePath);
+	auto now = std::chrono::steady_clock::now();
+	std::vector<PendingLog> ready;
+
+	for (auto it = pendingLogs.begin(); it != pendingLogs.end();)
+	{
+		if (isPendingLogReady(it->second, now))
+		{
+			ready.push_back(std::move(it->second));
+			it = pendingLogs.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	std::sort(ready.begin(), ready.end(), [](const PendingLog& a, const PendingLog& b)
+		{
+			return a.entry.lastWriteTime < b.entry.lastWriteTime;
+		});
+
+	for (const auto& pending : ready)
+	{
+		if (stopMonitoring)
+		{
+			break;
+		}
+		publishPendingLog(pending, processedFiles);
+	}
 }
 
 void parseInitialLogs(std::unordered_set<std::wstring>& processedFiles, size_t numLogsToParse)
@@ -120,148 +373,240 @@ void parseInitialLogs(std::unordered_set<std::wstring>& processedFiles, size_t n
 				"arcdps" / "arcdps.cbtlogs";
 		}
 
-		std::vector<std::filesystem::path> zevtcFiles;
+		prepareLogIndex(dirPath);
 
-		// Recursively search for .zevtc files in the directory
-		for (const auto& entry : std::filesystem::recursive_directory_iterator(dirPath))
-		{
-			if (entry.is_regular_file() && entry.path().extension() == L".zevtc")
-			{
-				if (isValidEVTCFile(dirPath, entry.path()))
-				{
-					zevtcFiles.push_back(entry.path());
-				}
-			}
-		}
+		std::vector<DirectoryIndex::Entry> logFiles = logIndex.getNewestFiles(numLogsToParse);
 
-		if (zevtcFiles.empty())
+		if (logFiles.empty())
 		{
 			APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-				("No valid .zevtc files found in directory: " + dirPath.string()).c_str());
+				("No valid .zevtc/.evtc files found in directory: " + dirPath.string()).c_str());
 			return;
 		}
 
-		// Sort descending order (newest first)
-		std::sort(zevtcFiles.begin(), zevtcFiles.end(),
-			[](const std::filesystem::path& a, const std::filesystem::path& b)
-			{
-				return std::filesystem::last_write_time(a) > std::filesystem::last_write_time(b);
-			});
-
-		size_t numFilesToParse = std::min<size_t>(zevtcFiles.size(), numLogsToParse);
+		std::vector<DirectoryIndex::Entry> backlog;
+		backlog.reserve(logFiles.size());
 
-		for (size_t i = 0; i < numFilesToParse; ++i)
+		for (const auto& entry : logFiles)
 		{
-			const std::filesystem::path& filePath = zevtcFiles[i];
-			waitForFile(filePath);
-
-			std::wstring absolutePath = std::filesystem::absolute(filePath).wstring();
-
-			if (processedFiles.find(absolutePath) == processedFiles.end())
+			// Historical logs are complete; only a log arcdps is writing
+			// right now has to wait, and the monitor loop publishes it.
+			if (checkLogReadiness(entry.path) == LogReadiness::Writing)
 			{
-				ParsedLog log;
-				log.filename = getUtf8Path(filePath.filename());
-				log.data = parseEVTCFile(filePath, settings);
-
-				if (shouldSkipLog(log, settings))
-				{
-					continue;
-				}
-
-				{
-					std::lock_guard<std::mutex> lock(parsedLogsMutex);
-					parsedLogs.push_back(log);
-
-					while (parsedLogs.size() > settings.logHistorySize)
-					{
-						parsedLogs.pop_back();
-					}
-					currentLogIndex = 0;
-					parsedLogsRevision.fetch_add(1, std::memory_order_relaxed);
-				}
-
-				processedFiles.insert(absolutePath);
-
-				auto fileTime = std::filesystem::last_write_time(filePath);
-				if (fileTime > maxProcessedTime)
-				{
-					maxProcessedTime = fileTime;
-				}
+				trackPendingLog(entry, std::chrono::steady_clock::now());
+				continue;
 			}
-			else
+
+			if (processedFiles.find(std::filesystem::absolute(entry.path).wstring()) != processedFiles.end())
 			{
 				APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-					("File already processed during initial parsing: " + getUtf8Path(filePath)).c_str());
+					("File already processed during initial parsing: " + getUtf8Path(entry.path)).c_str());
+				continue;
 			}
+
+			backlog.push_back(entry);
 		}
 
-		initialParsingComplete = true;
+		if (backlog.empty())
+		{
+			initialParsingComplete = true;
+			return;
+		}
+
+		// The pipeline publishes these in the background; live logs that
+		// arrive meanwhile overtake them.
+		// The extra one holds completion off until every log is submitted,
+		// however quickly the first ones finish.
+		backlogRemaining = backlog.size() + 1;
+		for (const auto& entry : backlog)
+		{
+			if (!processIndexedFile(entry, processedFiles, LogPriority::Backlog))
+			{
+				finishBacklogLog();
+			}
+		}
+		finishBacklogLog();
 	}
 	catch (const std::exception& ex)
 	{
 		APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
 			("Exception in initial parsing: " + std::string(ex.what())).c_str());
+		// Whatever was left unsubmitted will never finish
+		initialParsingComplete = true;
 	}
 }
 
-void scanForNewFiles(const std::filesystem::path& dirPath, std::unordered_set<std::wstring>& processedFiles)
+void scanForNewFiles(std::unordered_set<std::wstring>& processedFiles)
 {
 	try
 	{
-		std::vector<std::filesystem::path> zevtcFiles;
+		size_t indexedBefore = logIndex.size();
+		if (!logIndex.reconcile(CancellationToken(stopMonitoring)).empty() || logIndex.size() != indexedBefore)
+		{
+			logIndexDirty = true;
+		}
 
-		for (const auto& entry : std::filesystem::recursive_directory_iterator(dirPath))
+		// Oldest first, so each log lands in front of the previous one and
+		// maxProcessedTime only ever moves forward.
+		auto detectedAt = std::chrono::steady_clock::now();
+		for (const auto& entry : logIndex.getFilesNewerThan(maxProcessedTime))
 		{
-			if (entry.is_regular_file() && entry.path().extension() == L".zevtc")
+			if (stopMonitoring)
 			{
-				auto fileTime = std::filesystem::last_write_time(entry.path());
-
-				if (fileTime <= maxProcessedTime)
-					continue;
-
-				if (isValidEVTCFile(dirPath, entry.path()))
-				{
-					zevtcFiles.push_back(entry.path());
-				}
+				break;
 			}
+
+			queueLiveLog(entry, detectedAt, processedFiles);
 		}
+	}
+	catch (const std::exception& ex)
+	{
+		APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+			("Exception in scanning directory: " + std::string(ex.what())).c_str());
+	}
+}
 
-		std::sort(zevtcFiles.begin(), zevtcFiles.end(),
-			[](const std::filesystem::path& a, const std::filesystem::path& b)
-			{
-				return std::filesystem::last_write_time(a) > std::filesystem::last_write_time(b);
-			});
+void processWatchEvents(const std::vector<FileWatchEvent>& events, std::unordered_set<std::wstring>& processedFiles)
+{
+	// A log being written produces a burst of added/modified events for the
+	// same file; handle each file once per batch.
+	std::unordered_set<std::wstring> seenInBatch;
+	auto detectedAt = std::chrono::steady_clock::now();
+
+	for (const auto& event : events)
+	{
+		if (stopMonitoring)
+		{
+			break;
+		}
 
-		for (const auto& filePath : zevtcFiles)
+		if (!isEVTCLogFile(event.path))
 		{
-			auto fileTime = std::filesystem::last_write_time(filePath);
+			continue;
+		}
 
-			if (fileTime <= maxProcessedTime)
+		try
+		{
+			if (event.action == FileWatchEvent::Action::Removed)
 			{
-				break;
+				logIndex.remove(event.path);
+				logIndexDirty = true;
+				pendingLogs.erase(std::filesystem::absolute(event.path).wstring());
+				continue;
 			}
 
-			std::wstring absolutePath = std::filesystem::absolute(filePath).wstring();
+			DirectoryIndex::Entry entry;
+			if (!logIndex.update(event.path, &entry))
+			{
+				continue;
+			}
+			logIndexDirty = true;
 
-			if (processedFiles.find(absolutePath) != processedFiles.end())
+			if (!seenInBatch.insert(std::filesystem::absolute(entry.path).wstring()).second ||
+				entry.lastWriteTime <= maxProcessedTime)
 			{
 				continue;
 			}
 
-			processEVTCFile(filePath);
+			queueLiveLog(entry, detectedAt, processedFiles);
+		}
+		catch (const std::exception& ex)
+		{
+			APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+				("Exception handling change notification: " + std::string(ex.what())).c_str());
+		}
+	}
+}
 
-			processedFiles.insert(absolutePath);
+bool runMonitorLoop(FileWatcher& watcher, std::unordered_set<std::wstring>& processedFiles)
+{
+	const auto idleWaitTimeout = std::chrono::milliseconds(500);
+	const auto pendingWaitTimeout = std::chrono::milliseconds(100);
+	const auto consistencyCheckInterval = std::chrono::minutes(10);
+	const auto indexSaveInterval = std::chrono::minutes(1);
+	auto lastConsistencyCheck = std::chrono::steady_clock::now();
+	auto lastIndexSave = lastConsistencyCheck;
+	std::vector<FileWatchEvent> events;
+
+	while (!stopMonitoring)
+	{
+		events.clear();
+		// Poll more often while a log is waiting for its writer, in case
+		// finishing it produces no further notification.
+		FileWatchStatus status = watcher.wait(pendingLogs.empty() ? idleWaitTimeout : pendingWaitTimeout, events);
 
-			if (fileTime > maxProcessedTime)
-			{
-				maxProcessedTime = fileTime;
-			}
+		if (stopMonitoring)
+		{
+			break;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (status == FileWatchStatus::Timeout &&
+			(logIndexNeedsReconcile || now - lastConsistencyCheck >= consistencyCheckInterval))
+		{
+			status = FileWatchStatus::RescanRequired;
+		}
+		if (status == FileWatchStatus::RescanRequired)
+		{
+			lastConsistencyCheck = now;
+			logIndexNeedsReconcile = false;
+		}
+		if (now - lastIndexSave >= indexSaveInterval)
+		{
+			saveLogIndex();
+			lastIndexSave = now;
+		}
+
+		switch (status)
+		{
+		case FileWatchStatus::Changes:
+			processWatchEvents(events, processedFiles);
+			break;
+		case FileWatchStatus::RescanRequired:
+			scanForNewFiles(processedFiles);
+			break;
+		case FileWatchStatus::Timeout:
+			break;
+		case FileWatchStatus::Failed:
+			APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+				("Directory watch (" + std::string(watcher.getName()) + ") failed.").c_str());
+			return false;
+		}
+
+		if (!pendingLogs.empty())
+		{
+			checkPendingLogs(processedFiles);
 		}
 	}
-	catch (const std::exception& ex)
+
+	return true;
+}
+
+// Runs the monitor loop with the watcher reachable from
+// requestStopMonitoring, so a stop request can cut its wait short.
+static bool watchDirectory(FileWatcher& watcher, std::unordered_set<std::wstring>& processedFiles)
+{
 	{
-		APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-			("Exception in scanning directory: " + std::string(ex.what())).c_str());
+		std::lock_guard<std::mutex> lock(monitorControlMutex);
+		activeWatcher = &watcher;
+	}
+
+	auto clearActiveWatcher = []()
+		{
+			std::lock_guard<std::mutex> lock(monitorControlMutex);
+			activeWatcher = nullptr;
+		};
+
+	try
+	{
+		bool result = runMonitorLoop(watcher, processedFiles);
+		clearActiveWatcher();
+		return result;
+	}
+	catch (...)
+	{
+		clearActiveWatcher();
+		throw;
 	}
 }
 
@@ -321,101 +666,100 @@ void monitorDirectory(size_t numLogsToParse, size_t pollIntervalMilliseconds)
 				"arcdps" / "arcdps.cbtlogs";
 		}
 
+		pendingLogs.clear();
+		parseScheduler.setPolicy(static_cast<CombatParsePolicy>(settings.combatParsePolicy));
+		{
+			std::lock_guard<std::mutex> lock(monitorControlMutex);
+			parsePipeline = std::make_unique<ParsePipeline>(settings.parserWorkerCount, publishParsedLog, finishParsedLog);
+		}
+
 		parseInitialLogs(processedFiles, numLogsToParse);
 
+		std::unique_ptr<FileWatcher> watcher;
+
 		// Manual pure-polling fallback (e.g. change notifications misbehaving).
 		if (settings.forceLinuxCompatibilityMode)
 		{
 			APIDefs->Log(ELogLevel_INFO, ADDON_NAME,
 				"Compatibility mode enabled: using polling for directory monitoring.");
-
-			while (!stopMonitoring)
-			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(pollIntervalMilliseconds));
-
-				if (stopMonitoring)
-				{
-					break;
-				}
-
-				scanForNewFiles(dirPath, processedFiles);
-			}
-			return;
 		}
-
-		APIDefs->Log(ELogLevel_INFO, ADDON_NAME,
-			"Using FindFirstChangeNotification for directory monitoring.");
-
-		HANDLE hChange = FindFirstChangeNotificationW(
-			dirPath.wstring().c_str(),
-			TRUE,
-			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE |
-			FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION);
-
-		if (hChange == INVALID_HANDLE_VALUE)
+		else
 		{
-			DWORD err = GetLastError();
-			APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-				("FindFirstChangeNotificationW failed (error " + std::to_string(err) +
-					"); falling back to polling.").c_str());
-
-			while (!stopMonitoring)
+			watcher = createNativeFileWatcher();
+			if (watcher && !watcher->start(dirPath))
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(pollIntervalMilliseconds));
-
-				if (stopMonitoring)
-				{
-					break;
-				}
-
-				scanForNewFiles(dirPath, processedFiles);
+				APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+					("Failed to start " + std::string(watcher->getName()) + "; falling back to polling.").c_str());
+				watcher.reset();
 			}
-			return;
 		}
 
-		const DWORD waitTimeoutMs = 500;
-
-		while (!stopMonitoring)
+		bool monitored = false;
+		if (watcher)
 		{
-			DWORD waitStatus = WaitForSingleObject(hChange, waitTimeoutMs);
-
-			if (stopMonitoring)
-			{
-				break;
-			}
+			APIDefs->Log(ELogLevel_INFO, ADDON_NAME,
+				("Using " + std::string(watcher->getName()) + " for directory monitoring.").c_str());
 
-			if (waitStatus == WAIT_OBJECT_0)
+			monitored = watchDirectory(*watcher, processedFiles);
+			if (!monitored)
 			{
-				scanForNewFiles(dirPath, processedFiles);
-
-				if (!FindNextChangeNotification(hChange))
-				{
-					DWORD err = GetLastError();
-					APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-						("FindNextChangeNotification failed (error " + std::to_string(err) + ").").c_str());
-					break;
-				}
-			}
-			else if (waitStatus == WAIT_TIMEOUT)
-			{
-				continue;
-			}
-			else
-			{
-				DWORD err = GetLastError();
-				APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-					("WaitForSingleObject failed (error " + std::to_string(err) + ").").c_str());
-				break;
+				APIDefs->Log(ELogLevel_WARNING, ADDON_NAME, "Falling back to polling.");
 			}
 		}
 
-		FindCloseChangeNotification(hChange);
+		if (!monitored)
+		{
+			watcher = createPollingFileWatcher(pollIntervalMilliseconds);
+			watcher->start(dirPath);
+			watchDirectory(*watcher, processedFiles);
+		}
+		saveLogIndex();
 	}
 	catch (const std::exception& ex)
 	{
 		APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
 			("Exception in directory monitoring thread: " + std::string(ex.what())).c_str());
 	}
+
+	// Drops backlog that has not started and waits for logs in flight.
+	std::unique_ptr<ParsePipeline> pipeline;
+	{
+		std::lock_guard<std::mutex> lock(monitorControlMutex);
+		pipeline = std::move(parsePipeline);
+	}
+	pipeline.reset();
+}
+
+void requestStopMonitoring()
+{
+	stopMonitoring = true;
+
+	std::lock_guard<std::mutex> lock(monitorControlMutex);
+	if (activeWatcher)
+	{
+		activeWatcher->interrupt();
+	}
+	if (parsePipeline)
+	{
+		parsePipeline->cancel();
+	}
+}
+
+size_t getLogIndexMemoryUsage()
+{
+	return logIndexMemoryUsage;
+}
+
+size_t getParseBufferMemoryUsage()
+{
+	std::lock_guard<std::mutex> lock(monitorControlMutex);
+	return parsePipeline ? parsePipeline->getRetainedBufferBytes() : 0;
+}
+
+std::filesystem::path getLargestParsedLogPath()
+{
+	std::lock_guard<std::mutex> lock(largestLogMutex);
+	return largestLogPath;
 }
 
 static bool shouldSkipLog(const ParsedLog& log, const ParserSettingsSnapshot& settings)
@@ -426,13 +770,17 @@ static bool shouldSkipLog(const ParsedLog& log, const ParserSettingsSnapshot& se
 		return true;
 	}
 
-	if (log.data.totalIdentifiedPlayers == 0)
+	// Players on a team ID nobody has named yet still count: naming the ID
+	// later relabels the log in place.
+	bool hasTeamPlayers = std::any_of(log.data.teamStatsById.begin(), log.data.teamStatsById.end(),
+		[](const auto& team) { return team.second.totalPlayers > 0; });
+	if (!hasTeamPlayers)
 	{
 		if (settings.debugStringsMode) {
-			size_t teamCount = log.data.teamStats.size();
+			size_t teamCount = log.data.teamStatsById.size();
 			std::string teamInfo = "Teams found: " + std::to_string(teamCount);
-			for (const auto& [teamName, stats] : log.data.teamStats) {
-				teamInfo += " [" + teamName + ": " + std::to_string(stats.totalPlayers) + " players]";
+			for (const auto& [teamId, stats] : log.data.teamStatsById) {
+				teamInfo += " [" + std::to_string(teamId) + ": " + std::to_string(stats.totalPlayers) + " players]";
 			}
 			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
 				("Skipping log with no identified players: " + log.filename + " - " + teamInfo).c_str());
@@ -442,150 +790,40 @@ static bool shouldSkipLog(const ParsedLog& log, const ParserSettingsSnapshot& se
 		return true;
 	}
 
-	if (settings.minTotalPlayers > 0 && log.data.totalIdentifiedPlayers < (size_t)settings.minTotalPlayers)
-	{
-		APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-			("Skipping log below min total players (" + std::to_string(settings.minTotalPlayers) + "): " + log.filename + " (" + std::to_string(log.data.totalIdentifiedPlayers) + " players)").c_str());
-		return true;
-	}
-
-	if (settings.minTotalDeaths > 0 || settings.minTotalDowns > 0)
-	{
-		uint32_t totalDeaths = 0;
-		uint32_t totalDowns = 0;
-		for (const auto& [teamName, stats] : log.data.teamStats)
-		{
-			totalDeaths += stats.totalDeaths;
-			totalDowns += stats.totalDowned;
-		}
-
-		if (settings.minTotalDeaths > 0 && totalDeaths < (uint32_t)settings.minTotalDeaths)
-		{
-			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-				("Skipping log below min total deaths (" + std::to_string(settings.minTotalDeaths) + "): " + log.filename + " (" + std::to_string(totalDeaths) + " deaths)").c_str());
-			return true;
-		}
-
-		if (settings.minTotalDowns > 0 && totalDowns < (uint32_t)settings.minTotalDowns)
-		{
-			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-				("Skipping log below min total downs (" + std::to_string(settings.minTotalDowns) + "): " + log.filename + " (" + std::to_string(totalDowns) + " downs)").c_str());
-			return true;
-		}
-	}
-
-	if (settings.minCombatDuration > 0)
-	{
-		double durationSec = log.data.getCombatDurationSeconds();
-		if (durationSec < settings.minCombatDuration)
-		{
-			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-				("Skipping log below min combat duration (" + std::to_string(settings.minCombatDuration) + "s): " + log.filename + " (" + std::to_string(durationSec) + "s)").c_str());
-			return true;
-		}
-	}
-
 	return false;
 }
 
-void processNewEVTCFile(const std::filesystem::path& filePath)
+// Runs on the pipeline's publish thread, one log at a time. Every WvW log
+// goes into the history, which applies the filters; backlog only fills the
+// history, while live logs also feed the aggregates and raise alerts.
+static void publishParsedLog(const LogJob& job, ParsedLog&& log)
 {
-	std::string filename = getUtf8Path(filePath.filename());
-
-	newLogDetectedTime.store(-1.0f);
-
-	ParsedLog log;
-	log.filename = filename;
 	ParserSettingsSnapshot settings = Settings::GetParserSettingsSnapshot();
-	log.data = parseEVTCFile(filePath, settings);
-
-	if (shouldSkipLog(log, settings))
-	{
-		return;
-	}
+	bool isLive = job.priority == LogPriority::Live;
+	bool shown = false;
 
+	if (!shouldSkipLog(log, settings))
 	{
-		std::lock_guard<std::mutex> lock(parsedLogsMutex);
-		parsedLogs.push_front(log);
+		shown = logHistory.add(log, isLive, settings);
 
-		while (parsedLogs.size() > settings.logHistorySize)
+		std::error_code ec;
+		uintmax_t size = std::filesystem::file_size(job.path, ec);
+		std::lock_guard<std::mutex> lock(largestLogMutex);
+		if (!ec && size > largestLogSize)
 		{
-			parsedLogs.pop_back();
+			largestLogSize = size;
+			largestLogPath = job.path;
 		}
-
-		currentLogIndex = 0;
-		parsedLogsRevision.fetch_add(1, std::memory_order_relaxed);
 	}
 
+	if (!isLive || !shown)
 	{
-		std::lock_guard<std::mutex> lock(aggregateStatsMutex);
-
-		// Update total combat time
-		uint64_t fightDuration = 0;
-		if (log.data.combatEndTime > log.data.combatStartTime)
-		{
-			fightDuration = log.data.combatEndTime - log.data.combatStartTime;
-		}
-		globalAggregateStats.totalCombatTime += fightDuration;
-		globalAggregateStats.combatInstanceCount++;
-
-		// Aggregate team data
-		for (const auto& [teamName, stats] : log.data.teamStats)
-		{
-			auto& teamAgg = globalAggregateStats.teamAggregates[teamName];
-
-			// Update full team totals
-			teamAgg.teamTotals.totalPlayers += stats.totalPlayers;
-			teamAgg.teamTotals.totalDeaths += stats.totalDeaths;
-			teamAgg.teamTotals.totalDowned += stats.totalDowned;
-			teamAgg.teamTotals.instanceCount++;
-
-			for (const auto& [eliteSpec, specStats] : stats.eliteSpecStats)
-			{
-				teamAgg.teamTotals.eliteSpecTotals[eliteSpec].totalCount += specStats.count;
-			}
-
-			// POV team updates
-			if (stats.isPOVTeam) {
-				teamAgg.isPOVTeam = true;
-				teamAgg.povSquadTotals.totalPlayers += stats.squadStats.totalPlayers;
-				teamAgg.povSquadTotals.totalDeaths += stats.squadStats.totalDeaths;
-				teamAgg.povSquadTotals.totalDowned += stats.squadStats.totalDowned;
-				teamAgg.povSquadTotals.instanceCount++;
-
-				for (const auto& [eliteSpec, specStats] : stats.squadStats.eliteSpecStats)
-				{
-					teamAgg.povSquadTotals.eliteSpecTotals[eliteSpec].totalCount += specStats.count;
-				}
-			}
-		}
-
-		// Compute and cache averages
-		cachedAverages.averageCombatTime = globalAggregateStats.getAverageCombatTime();
-		cachedAverages.averageTeamPlayerCounts.clear();
-		cachedAverages.averageTeamSpecCounts.clear();
-		cachedAverages.averagePOVSquadPlayerCounts.clear();
-		cachedAverages.averagePOVSquadSpecCounts.clear();
-
-		for (const auto& [teamName, teamAgg] : globalAggregateStats.teamAggregates)
-		{
-			// Full team averages
-			cachedAverages.averageTeamPlayerCounts[teamName] = teamAgg.getAverageTeamPlayerCount();
-
-			for (const auto& [specName, _] : teamAgg.teamTotals.eliteSpecTotals)
-			{
-				cachedAverages.averageTeamSpecCounts[teamName][specName] = teamAgg.getAverageTeamSpecCount(specName);
-			}
+		return;
+	}
 
-			// POV squad averages if POV
-			if (teamAgg.isPOVTeam) {
-				cachedAverages.averagePOVSquadPlayerCounts[teamName] = teamAgg.getAveragePOVSquadPlayerCount();
-				for (const auto& [specName, _] : teamAgg.povSquadTotals.eliteSpecTotals)
-				{
-					cachedAverages.averagePOVSquadSpecCounts[teamName][specName] = teamAgg.getAveragePOVSquadSpecCount(specName);
-				}
-			}
-		}
+	if (job.detectedAt != std::chrono::steady_clock::time_point{})
+	{
+		parseMetrics.detectionToPublish.record(std::chrono::steady_clock::now() - job.detectedAt);
 	}
 
 	if (settings.showNewParseAlert) {
@@ -598,3 +836,13 @@ void processNewEVTCFile(const std::filesystem::path& filePath)
 	LogParsedEventArgs args{log.filename.c_str(), &log.data};
 	APIDefs->Events.Raise(EV_LOG_PARSED, &args);
 }
+
+// Runs once per submitted log however the pipeline was done with it, so a
+// backlog log that failed to load or parse still counts toward completion.
+static void finishParsedLog(const LogJob& job)
+{
+	if (job.priority == LogPriority::Backlog)
+	{
+		finishBacklogLog();
+	}
+}
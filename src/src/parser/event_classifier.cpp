@@ -0,0 +1,173 @@
+#include "parser/event_classifier.h"
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define EVENT_CLASSIFIER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr uint32_t kStrikeDamage = 1u << 0;
+    constexpr uint32_t kCondiDamage = 1u << 1;
+    constexpr uint32_t kKillingBlow = 1u << 2;
+    constexpr uint32_t kStrip = 1u << 3;
+    constexpr uint32_t kStateChange = 1u << 4;
+    constexpr uint32_t kActivation = 1u << 5;
+
+    // The flag bytes the classifier reads sit together at the end of the
+    // event: iff, buff, result, isActivation at 48, isBuffRemove at 52 and
+    // isStateChange at 56.
+    constexpr size_t kFlagBlockOffset = offsetof(CombatEvent, iff);
+    static_assert(sizeof(CombatEvent) == 64, "CombatEvent layout changed");
+    static_assert(offsetof(CombatEvent, iff) == 48 && offsetof(CombatEvent, buff) == 49 &&
+        offsetof(CombatEvent, result) == 50 && offsetof(CombatEvent, isActivation) == 51 &&
+        offsetof(CombatEvent, isBuffRemove) == 52 && offsetof(CombatEvent, isStateChange) == 56,
+        "Classifier flag offsets changed");
+
+    constexpr uint8_t kKillingBlowResult = static_cast<uint8_t>(ResultCode::KillingBlow);
+    constexpr uint8_t kBuffRemoveAll = static_cast<uint8_t>(BuffRemove::All);
+    constexpr uint8_t kActivationNormal = static_cast<uint8_t>(Activation::Normal);
+    constexpr uint8_t kActivationQuickness = static_cast<uint8_t>(Activation::Quickness);
+
+    uint32_t classifyEvent(const CombatEvent& event) {
+        if (event.isStateChange != static_cast<uint8_t>(StateChange::None)) {
+            return kStateChange;
+        }
+        if (event.isActivation != static_cast<uint8_t>(Activation::None)) {
+            return event.isActivation == kActivationNormal || event.isActivation == kActivationQuickness
+                ? kActivation : 0;
+        }
+        if (event.isBuffRemove != static_cast<uint8_t>(BuffRemove::None)) {
+            return event.isBuffRemove == kBuffRemoveAll ? kStrip : 0;
+        }
+        // Normal, Critical and Glance are 0 to 2
+        if (event.result > static_cast<uint8_t>(ResultCode::Glance) && event.result != kKillingBlowResult) {
+            return 0;
+        }
+
+        uint32_t kinds = event.result == kKillingBlowResult ? kKillingBlow : 0;
+        if (event.buff == 0) {
+            kinds |= kStrikeDamage;
+        }
+        else if (event.buff == 1) {
+            kinds |= kCondiDamage;
+        }
+        return kinds;
+    }
+
+    void appendEvent(EventStreams& streams, uint32_t index, uint32_t kinds) {
+        if (kinds & kStrikeDamage) {
+            streams.strikeDamage.push_back(index);
+        }
+        if (kinds & kCondiDamage) {
+            streams.condiDamage.push_back(index);
+        }
+        if (kinds & kKillingBlow) {
+            streams.killingBlows.push_back(index);
+        }
+        if (kinds & kStrip) {
+            streams.strips.push_back(index);
+        }
+        if (kinds & kStateChange) {
+            streams.stateChanges.push_back(index);
+        }
+        if (kinds & kActivation) {
+            streams.activations.push_back(index);
+        }
+    }
+
+#ifdef EVENT_CLASSIFIER_SSE2
+    // Classifies four events at once. The 16 flag bytes of each event are
+    // loaded and transposed so each register holds one dword of all four:
+    // iff/buff/result/isActivation, then isBuffRemove, then isStateChange.
+    void classifyFour(const char* flagBlock, uint32_t firstIndex, EventStreams& streams) {
+        __m128i e0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(flagBlock));
+        __m128i e1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(flagBlock + sizeof(CombatEvent)));
+        __m128i e2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(flagBlock + 2 * sizeof(CombatEvent)));
+        __m128i e3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(flagBlock + 3 * sizeof(CombatEvent)));
+
+        __m128i lo01 = _mm_unpacklo_epi32(e0, e1);
+        __m128i lo23 = _mm_unpacklo_epi32(e2, e3);
+        __m128i hi01 = _mm_unpackhi_epi32(e0, e1);
+        __m128i hi23 = _mm_unpackhi_epi32(e2, e3);
+        __m128i hitFlags = _mm_unpacklo_epi64(lo01, lo23);
+        __m128i removeFlags = _mm_unpackhi_epi64(lo01, lo23);
+        __m128i stateFlags = _mm_unpacklo_epi64(hi01, hi23);
+
+        const __m128i byteMask = _mm_set1_epi32(0xFF);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi32(1);
+
+        __m128i buff = _mm_and_si128(_mm_srli_epi32(hitFlags, 8), byteMask);
+        __m128i result = _mm_and_si128(_mm_srli_epi32(hitFlags, 16), byteMask);
+        __m128i activation = _mm_srli_epi32(hitFlags, 24);
+        __m128i buffRemove = _mm_and_si128(removeFlags, byteMask);
+        __m128i stateChange = _mm_and_si128(stateFlags, byteMask);
+
+        __m128i noStateChange = _mm_cmpeq_epi32(stateChange, zero);
+        __m128i plain = _mm_and_si128(noStateChange, _mm_cmpeq_epi32(activation, zero));
+        __m128i castStart = _mm_and_si128(noStateChange, _mm_or_si128(
+            _mm_cmpeq_epi32(activation, _mm_set1_epi32(kActivationNormal)),
+            _mm_cmpeq_epi32(activation, _mm_set1_epi32(kActivationQuickness))));
+        __m128i strip = _mm_and_si128(plain, _mm_cmpeq_epi32(buffRemove, _mm_set1_epi32(kBuffRemoveAll)));
+        __m128i killingBlow = _mm_cmpeq_epi32(result, _mm_set1_epi32(kKillingBlowResult));
+        __m128i damageResult = _mm_or_si128(
+            _mm_cmplt_epi32(result, _mm_set1_epi32(static_cast<int>(ResultCode::Glance) + 1)), killingBlow);
+        __m128i hit = _mm_and_si128(_mm_and_si128(plain, _mm_cmpeq_epi32(buffRemove, zero)), damageResult);
+
+        auto laneMask = [](__m128i lanes) {
+            return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(lanes)));
+        };
+        uint32_t strikeLanes = laneMask(_mm_and_si128(hit, _mm_cmpeq_epi32(buff, zero)));
+        uint32_t condiLanes = laneMask(_mm_and_si128(hit, _mm_cmpeq_epi32(buff, one)));
+        uint32_t killLanes = laneMask(_mm_and_si128(hit, killingBlow));
+        uint32_t stripLanes = laneMask(strip);
+        uint32_t stateLanes = ~laneMask(noStateChange) & 0xF;
+        uint32_t activationLanes = laneMask(castStart);
+
+        // Most groups of four are buff applications and the like
+        if ((strikeLanes | condiLanes | killLanes | stripLanes | stateLanes | activationLanes) == 0) {
+            return;
+        }
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            uint32_t bit = 1u << lane;
+            uint32_t kinds = ((strikeLanes & bit) ? kStrikeDamage : 0) |
+                ((condiLanes & bit) ? kCondiDamage : 0) |
+                ((killLanes & bit) ? kKillingBlow : 0) |
+                ((stripLanes & bit) ? kStrip : 0) |
+                ((stateLanes & bit) ? kStateChange : 0) |
+                ((activationLanes & bit) ? kActivation : 0);
+            if (kinds != 0) {
+                appendEvent(streams, firstIndex + lane, kinds);
+            }
+        }
+    }
+#endif
+}
+
+EventStreams classifyEvents(const CombatEventView& events, const CancellationToken& token) {
+    EventStreams streams;
+    const uint32_t count = static_cast<uint32_t>(events.size());
+    uint32_t index = 0;
+
+#ifdef EVENT_CLASSIFIER_SSE2
+    const char* flagBlock = reinterpret_cast<const char*>(events.begin()) + kFlagBlockOffset;
+    for (; index + 4 <= count; index += 4) {
+        if (token.poll()) {
+            return streams;
+        }
+        classifyFour(flagBlock + static_cast<size_t>(index) * sizeof(CombatEvent), index, streams);
+    }
+#endif
+
+    for (; index < count; ++index) {
+        if (token.poll()) {
+            return streams;
+        }
+        uint32_t kinds = classifyEvent(events[index]);
+        if (kinds != 0) {
+            appendEvent(streams, index, kinds);
+        }
+    }
+    return streams;
+}
@@ -5,6 +5,15 @@
 #include "shared/Shared.h"
 #include "utils/Utils.h"
 #include "parser/statistics_helper.h"
+#include "parser/buffer_pool.h"
+#include "parser/mapped_file.h"
+#include "parser/parse_metrics.h"
+#include "parser/event_classifier.h"
+#include "parser/combat_analyzers.h"
+#include "parser/parse_scheduler.h"
+#include "parser/boon_strip_skills.h"
+#include "parser/skill_table.h"
+#include <exception>
 #include <thread>
 #include <chrono>
 #include <filesystem>
@@ -16,81 +25,25 @@
 #include <vector>
 #include <mutex>
 
-std::unordered_map<uint64_t, AgentState> preProcessAgentStates(const std::vector<CombatEvent>& events) {
-	std::unordered_map<uint64_t, AgentState> agentStates;
-
-	for (const auto& event : events) {
-		auto& state = agentStates[event.srcAgent];
-
-		// Store all state change events for precise sequencing
-		if (event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDown) ||
-			event.isStateChange == static_cast<uint8_t>(StateChange::ChangeUp) ||
-			event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDead) ||
-			event.isStateChange == static_cast<uint8_t>(StateChange::HealthUpdate)) {
-			state.relevantEvents.push_back(event);
-		}
-
-		// Also maintain interval structures for quick filtering
-		if (event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDown)) {
-			state.downIntervals.emplace_back(event.time, UINT64_MAX);
-			state.currentlyDowned = true;
-		}
-		else if (event.isStateChange == static_cast<uint8_t>(StateChange::ChangeUp)) {
-			if (state.currentlyDowned && !state.downIntervals.empty()) {
-				state.downIntervals.back().second = event.time;
-				state.currentlyDowned = false;
-			}
-		}
-		else if (event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDead)) {
-			if (state.currentlyDowned && !state.downIntervals.empty()) {
-				state.downIntervals.back().second = event.time;
-				state.currentlyDowned = false;
-			}
-			state.deathIntervals.emplace_back(event.time, UINT64_MAX);
-		}
-		else if (event.isStateChange == static_cast<uint8_t>(StateChange::HealthUpdate)) {
-			if (event.value > 0) {
-				float healthPercent = (event.dstAgent * 100.0f) / event.value;
-				state.healthUpdates.emplace_back(event.time, healthPercent);
-			}
-		}
-	}
-
-	// Sort all intervals and events
-	for (auto& [_, state] : agentStates) {
-		std::sort(state.healthUpdates.begin(), state.healthUpdates.end());
-		std::sort(state.downIntervals.begin(), state.downIntervals.end());
-		std::sort(state.deathIntervals.begin(), state.deathIntervals.end());
-
-		// Use explicit comparison function for CombatEvents
-		std::sort(state.relevantEvents.begin(), state.relevantEvents.end(),
-			[](const CombatEvent& a, const CombatEvent& b) -> bool {
-				return a.time < b.time;
-			});
-	}
-
-	return agentStates;
-}
-
-void parseAgents(const std::vector<char>& bytes, size_t& offset, uint32_t agentCount,
+void parseAgents(const char* data, size_t size, size_t& offset, uint32_t agentCount,
 	std::unordered_map<uint64_t, Agent>& agentsByAddress) {
 
 	const size_t agentBlockSize = 96; // Each agent block is 96 bytes
 
 	for (uint32_t i = 0; i < agentCount; ++i) {
-		if (offset + agentBlockSize > bytes.size()) {
+		if (offset + agentBlockSize > size) {
 			APIDefs->Log(ELogLevel_WARNING, ADDON_NAME, "Insufficient data for agent block");
 			break;
 		}
 
 		Agent agent;
-		std::memcpy(&agent.address, bytes.data() + offset, sizeof(uint64_t));
-		std::memcpy(&agent.professionId, bytes.data() + offset + 8, sizeof(uint32_t));
-		std::memcpy(&agent.eliteSpecId, bytes.data() + offset + 12, sizeof(int32_t));
+		std::memcpy(&agent.address, data + offset, sizeof(uint64_t));
+		std::memcpy(&agent.professionId, data + offset + 8, sizeof(uint32_t));
+		std::memcpy(&agent.eliteSpecId, data + offset + 12, sizeof(int32_t));
 
 		// Read the full 68-byte name field
 		char nameData[68];
-		std::memcpy(nameData, bytes.data() + offset + 28, 68);
+		std::memcpy(nameData, data + offset + 28, 68);
 		nameData[67] = '\0'; // Ensure null termination
 
 		// Split the nameData into substrings
@@ -156,369 +109,189 @@ void parseAgents(const std::vector<char>& bytes, size_t& offset, uint32_t agentC
 		offset += agentBlockSize;
 	}
 }
-static constexpr uint8_t SC_ID_TO_GUID = 46;
-
-static std::string guidToHex(uint64_t first8, uint64_t last8) {
-	static const char hex[] = "0123456789ABCDEF";
-	std::string s;
-	s.reserve(32);
-	for (int i = 0; i < 8; ++i) {
-		uint8_t b = (first8 >> (i * 8)) & 0xFF;
-		s += hex[b >> 4]; s += hex[b & 0xF];
-	}
-	for (int i = 0; i < 8; ++i) {
-		uint8_t b = (last8 >> (i * 8)) & 0xFF;
-		s += hex[b >> 4]; s += hex[b & 0xF];
-	}
-	return s;
-}
 
-static const std::unordered_map<std::string, std::string> WVW_TEAM_COLOR_GUIDS = {
-	{"BC8AEAEF73DC8C43B041CEDFEA4D5020", "Green"},
-	{"5D22513B9498EB48944E94EC7A8DD657", "Red"},
-	{"CF6F7C254FCB184CBCCE4738EADD8388", "Blue"},
+// How the stats pass runs; the benchmark pins the thread count and reads back
+// the time.
+struct AccumulationOptions {
+	// 0 picks from the log size and the cores free
+	size_t threads = 0;
+	std::chrono::steady_clock::duration* elapsed = nullptr;
 };
 
-void parseCombatEvents(const std::vector<char>& bytes, size_t offset, size_t eventCount,
-	std::unordered_map<uint64_t, Agent>& agentsByAddress,
-	std::unordered_map<uint16_t, Agent*>& playersBySrcInstid,
-	ParsedData& result,
-	const ParserSettingsSnapshot& settings) {
-
-	uint64_t logStartTime = UINT64_MAX;
-	uint64_t logEndTime = 0;
-	uint64_t logStartUnix = 0;
-	uint64_t logEndUnix = 0;
-	result.combatStartTime = UINT64_MAX;
-	result.combatEndTime = 0;
-	uint64_t earliestTime = UINT64_MAX;
-	uint64_t latestTime = 0;
-	uint64_t earliestValidRecordingTime = UINT64_MAX;
-	uint64_t latestValidRecordingTime = 0;
-	uint64_t povAgentID = 0;
-
-	const size_t eventSize = sizeof(CombatEvent);
-	std::unordered_map<uint16_t, Agent*> agentsByInstid;
-	std::unordered_map<uint64_t, uint16_t> ptr_to_instid;
-	std::unordered_set<uint64_t> active_ptrs;
-
-	std::vector<CombatEvent> allEvents;
-	allEvents.reserve(eventCount);
-
-	// First pass: collect all events
-	for (size_t i = 0; i < eventCount; ++i) {
-		size_t eventOffset = offset + (i * eventSize);
-		if (eventOffset + eventSize > bytes.size()) {
-			break;
-		}
-		CombatEvent event;
-		std::memcpy(&event, bytes.data() + eventOffset, eventSize);
-		allEvents.push_back(event);
-	}
-
-	auto agentStates = preProcessAgentStates(allEvents);
-
-	// Pre-scan IDToGUID events to auto-detect WvW team colors from stable GUIDs.
-	std::unordered_map<uint32_t, std::string> teamIdToColor;
-	for (const auto& ev : allEvents) {
-		if (ev.isStateChange != SC_ID_TO_GUID || ev.skillId == 0) continue;
-		auto it = WVW_TEAM_COLOR_GUIDS.find(guidToHex(ev.srcAgent, ev.dstAgent));
-		if (it != WVW_TEAM_COLOR_GUIDS.end())
-			teamIdToColor[ev.skillId] = it->second;
-	}
-
-	// Process all events
-	for (const auto& event : allEvents) {
-		earliestTime = std::min(earliestTime, event.time);
-		latestTime = std::max(latestTime, event.time);
-		constexpr uint64_t kMaxReasonableRecordingTimeMs = 7ULL * 24ULL * 60ULL * 60ULL * 1000ULL;
-		if (event.time < kMaxReasonableRecordingTimeMs) {
-			earliestValidRecordingTime = std::min(earliestValidRecordingTime, event.time);
-			latestValidRecordingTime = std::max(latestValidRecordingTime, event.time);
-		}
+// Below this many events per chunk a thread costs more than it saves.
+static constexpr size_t kMinEventsPerAccumulationChunk = 100000;
+static constexpr size_t kMaxAccumulationThreads = 16;
+// Every chunk but the first has its own per-skill counters; this caps their
+// total, so logs with many skill groups use fewer threads.
+static constexpr size_t kMaxChunkSkillCounterBytes = 32 * 1024 * 1024;
+
+static size_t chooseAccumulationThreads(size_t eventCount, const ParserSettingsSnapshot& settings) {
+	// Stay on the parse thread when the scheduler is holding parsing back.
+	if (parseScheduler.getPolicy() != CombatParsePolicy::FullSpeed && isPlayerInCombat()) {
+		return 1;
+	}
+	// Leave the cores the other parse workers are using.
+	size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	size_t byCores = cores / std::max<size_t>(settings.parserWorkerCount, 1);
+	size_t byWork = eventCount / kMinEventsPerAccumulationChunk;
+	return std::clamp<size_t>(std::min(byCores, byWork), 1, kMaxAccumulationThreads);
+}
 
-		if (event.srcAgent != 0 && event.srcInstid != 0 &&
-			agentsByAddress.count(event.srcAgent)) {
-			ptr_to_instid.emplace(event.srcAgent, event.srcInstid);
-		}
-		if (event.dstAgent != 0 && event.dstInstid != 0 &&
-			agentsByAddress.count(event.dstAgent)) {
-			ptr_to_instid.emplace(event.dstAgent, event.dstInstid);
-		}
+// Splits the events into time-ordered chunks, adds each chunk into its own
+// stats and sums them at the end. The down and kill checks read whole
+// per-agent timelines built beforehand and every counter is a plain sum, so
+// the result is the same as one pass over all events.
+//
+// Chunk threads run at the calling worker's priority and pace like it. An
+// exception in any chunk is rethrown here once every thread has joined.
+static void accumulateCombatStats(const AccumulationContext& context,
+	std::unordered_map<uint32_t, TeamStats>& teamStatsById, FightRangeIndex& rangeIndex,
+	PlayerCounters& players, SkillCounters& skills, size_t threadCount, const CancellationToken& token) {
+	const size_t eventCount = context.events.size();
+	threadCount = std::min(threadCount, std::max<size_t>(eventCount, 1));
+	const size_t skillCounterBytes = skills.groupCount * skills.skillCount *
+		(2 * sizeof(uint64_t) + sizeof(uint32_t));
+	if (skillCounterBytes != 0) {
+		threadCount = std::min(threadCount, 1 + kMaxChunkSkillCounterBytes / skillCounterBytes);
+	}
+	if (threadCount <= 1) {
+		accumulateEventRange(context, 0, eventCount, teamStatsById, rangeIndex, players, skills, token);
+		return;
+	}
 
-		switch (static_cast<StateChange>(event.isStateChange)) {
-		case StateChange::LogStart:
-			logStartTime = event.time;
-			if (logStartUnix == 0 && event.value != 0 && event.buffDmg != 0)
-				logStartUnix = static_cast<uint32_t>(event.value);
-			break;
-		case StateChange::LogEnd:
-			logEndTime = event.time;
-			if (event.value != 0 && event.buffDmg != 0)
-				logEndUnix = static_cast<uint32_t>(event.value);
-			break;
-		case StateChange::EnterCombat:
-			result.combatStartTime = std::min(result.combatStartTime, event.time);
-			break;
-		case StateChange::ExitCombat:
-			result.combatEndTime = std::max(result.combatEndTime, event.time);
-			break;
-		case StateChange::PointOfView:
-			povAgentID = event.srcAgent;
-			break;
-		case StateChange::None:
-			if (agentsByAddress.find(event.srcAgent) != agentsByAddress.end()) {
-				active_ptrs.insert(event.srcAgent);
-				Agent& agent = agentsByAddress[event.srcAgent];
-				agent.id = event.srcInstid;
-				agentsByInstid[event.srcInstid] = &agent;
-				playersBySrcInstid[event.srcInstid] = &agent;
-			}
-			if (agentsByAddress.find(event.dstAgent) != agentsByAddress.end()) {
-				Agent& agent = agentsByAddress[event.dstAgent];
-				agent.id = event.dstInstid;
-				agentsByInstid[event.dstInstid] = &agent;
+	// resolveStatBlocks reads isPOVTeam to decide on squad stats, so each chunk
+	// starts with the POV flags already set.
+	std::vector<std::unordered_map<uint32_t, TeamStats>> chunkStats(threadCount);
+	for (auto& stats : chunkStats) {
+		for (const auto& [teamId, teamStats] : teamStatsById) {
+			if (teamStats.isPOVTeam) {
+				stats[teamId].isPOVTeam = true;
 			}
-			break;
-		case StateChange::TeamChange: {
-			uint32_t teamID = static_cast<uint32_t>(event.value);
-			if (teamID != 0 && agentsByAddress.find(event.srcAgent) != agentsByAddress.end()) {
-				Agent& agent = agentsByAddress[event.srcAgent];
-
-				std::string teamName;
-				auto gitc = teamIdToColor.find(teamID);
-				if (gitc != teamIdToColor.end()) {
-					teamName = gitc->second;
-				} else {
-					auto it = settings.teamIDs.find(teamID);
-					if (it != settings.teamIDs.end())
-						teamName = it->second;
-				}
+		}
+	}
+	std::vector<FightRangeIndex> chunkRangeIndexes(threadCount);
+	for (auto& chunkIndex : chunkRangeIndexes) {
+		chunkIndex.combatStartTime = rangeIndex.combatStartTime;
+		chunkIndex.bucketMs = rangeIndex.bucketMs;
+		chunkIndex.bucketCount = rangeIndex.bucketCount;
+	}
+	std::vector<PlayerCounters> chunkPlayers(threadCount);
+	for (auto& chunkCounters : chunkPlayers) {
+		chunkCounters.resize(players.column(PlayerStat::Damage).size());
+	}
+	// The first chunk adds straight into the skill counters, which start empty
+	std::vector<SkillCounters> chunkSkills(threadCount - 1);
+	for (auto& chunkCounters : chunkSkills) {
+		chunkCounters.resize(skills.groupCount, skills.skillCount);
+	}
 
-				if (settings.debugStringsMode) {
-					std::string agentInfo = agent.name.empty() ? agent.accountName : agent.name;
-					if (agentInfo.empty()) agentInfo = "Unknown Agent";
-					if (!teamName.empty()) {
-						APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-							("TeamChange: Agent '" + agentInfo + "' assigned to team ID " +
-							std::to_string(teamID) + " (" + teamName + ")").c_str());
-					} else {
-						APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-							("TeamChange: Agent '" + agentInfo + "' has UNKNOWN team ID " +
-							std::to_string(teamID) + " (not in GUID map or settings)").c_str());
-					}
-				}
+	size_t chunkSize = (eventCount + threadCount - 1) / threadCount;
+	auto chunkBegin = [&](size_t chunk) { return std::min(chunk * chunkSize, eventCount); };
 
-				if (!teamName.empty()) {
-					agent.team = teamName;
+	std::vector<std::exception_ptr> chunkErrors(threadCount);
+	const int workerPriority = getCurrentThreadPriority();
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (size_t chunk = 1; chunk < threadCount; ++chunk) {
+		threads.emplace_back([&, chunk]() {
+			try {
+				adoptThreadPriority(workerPriority);
+				// Tokens count polls, so each thread gets its own copy.
+				CancellationToken chunkToken = token;
+				if (chunkToken.checkpoint()) {
+					return;
 				}
+				accumulateEventRange(context, chunkBegin(chunk), chunkBegin(chunk + 1), chunkStats[chunk],
+					chunkRangeIndexes[chunk], chunkPlayers[chunk], chunkSkills[chunk - 1], chunkToken);
 			}
-			break;
-		}
-		default:
-			break;
+			catch (...) {
+				chunkErrors[chunk] = std::current_exception();
+			}
+		});
+	}
+	try {
+		accumulateEventRange(context, chunkBegin(0), chunkBegin(1), chunkStats[0], chunkRangeIndexes[0],
+			chunkPlayers[0], skills, token);
+	}
+	catch (...) {
+		chunkErrors[0] = std::current_exception();
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (const auto& error : chunkErrors) {
+		if (error) {
+			std::rethrow_exception(error);
 		}
 	}
 
-	// Set POV team
-	std::string povTeam;
-	if (agentsByAddress.find(povAgentID) != agentsByAddress.end()) {
-		Agent& povAgent = agentsByAddress[povAgentID];
-		povTeam = povAgent.team;
-		if (!povTeam.empty() && povTeam != "Unknown") {
-			result.teamStats[povTeam].isPOVTeam = true;
-			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-				("POV Agent Team: " + povTeam).c_str());
-		}
-		else {
-			APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-				("POV Agent's team is unknown - AgentID: " + std::to_string(povAgentID)).c_str());
+	for (const auto& stats : chunkStats) {
+		for (const auto& [teamId, teamStats] : stats) {
+			mergeTeamStats(teamStatsById[teamId], teamStats);
 		}
 	}
+	for (const auto& chunkIndex : chunkRangeIndexes) {
+		mergeRangeIndex(rangeIndex, chunkIndex);
+	}
+	for (const auto& chunkCounters : chunkPlayers) {
+		mergePlayerCounters(players, chunkCounters);
+	}
+	for (const auto& chunkCounters : chunkSkills) {
+		mergeSkillCounters(skills, chunkCounters);
+	}
+}
 
-	// Set combat times
-	if (result.combatStartTime == UINT64_MAX) {
-		result.combatStartTime = (logStartTime != UINT64_MAX) ? logStartTime : earliestTime;
-	}
-	if (result.combatEndTime == 0) {
-		result.combatEndTime = (logEndTime != 0) ? logEndTime : latestTime;
-	}
-
-	uint64_t recordingDurationSeconds = 0;
-	if (earliestValidRecordingTime != UINT64_MAX && latestValidRecordingTime >= earliestValidRecordingTime) {
-		recordingDurationSeconds = (latestValidRecordingTime - earliestValidRecordingTime + 500) / 1000;
-	}
-
-	if (logStartUnix == 0 && logEndUnix != 0) {
-		logStartUnix = logEndUnix > recordingDurationSeconds
-			? logEndUnix - recordingDurationSeconds
-			: 0;
-	}
-	else if (logEndUnix == 0 && logStartUnix != 0) {
-		logEndUnix = logStartUnix + recordingDurationSeconds;
-	}
-
-	if (logStartUnix != 0 && logEndUnix != 0 && logEndUnix < logStartUnix) {
-		logEndUnix = logStartUnix + recordingDurationSeconds;
-	}
-
-	result.logStartUnix = logStartUnix;
-	result.logEndUnix = logEndUnix;
-
-	// Process deaths and downs events
-	for (const auto& event : allEvents) {
-		StateChange stateChange = static_cast<StateChange>(event.isStateChange);
-		if (stateChange == StateChange::ChangeDead || stateChange == StateChange::ChangeDown) {
-			uint16_t srcInstid = event.srcInstid;
-			auto agentIt = agentsByInstid.find(srcInstid);
-			if (agentIt != agentsByInstid.end()) {
-				Agent* agent = agentIt->second;
-				const std::string& team = agent->team;
-				if (team != "Unknown") {
-					auto& teamStats = result.teamStats[team];
-					if (stateChange == StateChange::ChangeDead) {
-						teamStats.totalDeaths++;
-						teamStats.eliteSpecStats[agent->eliteSpec].totalDeaths++;
-						if (teamStats.isPOVTeam && agent->subgroupNumber > 0) {
-							teamStats.squadStats.totalDeaths++;
-							teamStats.squadStats.eliteSpecStats[agent->eliteSpec].totalDeaths++;
-						}
-					}
-					else {
-						teamStats.totalDowned++;
-						teamStats.eliteSpecStats[agent->eliteSpec].totalDowned++;
-						if (teamStats.isPOVTeam && agent->subgroupNumber > 0) {
-							teamStats.squadStats.totalDowned++;
-							teamStats.squadStats.eliteSpecStats[agent->eliteSpec].totalDowned++;
-						}
-					}
-				}
-			}
-		}
+void parseCombatEvents(const CombatEventView& allEvents,
+	std::unordered_map<uint64_t, Agent>& agentsByAddress,
+	std::unordered_map<uint16_t, Agent*>& playersBySrcInstid,
+	const LogSkillTable& skills,
+	ParsedData& result,
+	const ParserSettingsSnapshot& settings,
+	const AccumulationOptions& accumulation,
+	const CancellationToken& token) {
+
+	EventStreams streams = classifyEvents(allEvents, token);
+	LogPassResult pass;
+	if (!runLogPass(allEvents, streams, agentsByAddress, playersBySrcInstid, result, pass, settings, token)) {
+		return;
 	}
 
-	// Process damage, kills, and strips events
-	for (const auto& event : allEvents) {
-		if (event.isStateChange == static_cast<uint8_t>(StateChange::None)) {
-			if (event.isActivation == static_cast<uint8_t>(Activation::None)) {
-				// Handle buff removals (strips)
-				if (event.isBuffRemove != static_cast<uint8_t>(BuffRemove::None)) {
-					// Skip if destination agent is 0 (unknown) - since dst is now our stripper
-					if (event.dstAgent == 0) {
-						continue;
-					}
-					// Skip if it's a self-strip
-					if (event.srcInstid == event.dstInstid) {
-						continue;
-					}
-					// Skip if overstackValue (RemovedDuration) is 0
-					if (event.value == 0) {
-						continue;
-					}
-					// Only count "All" removals of specific boons
-					if (event.isBuffRemove == static_cast<uint8_t>(BuffRemove::All) &&
-						isTrackedBoon(event.skillId)) {
-
-						// Look up the destination agent (stripper) instead of source
-						auto dstIt = playersBySrcInstid.find(event.dstInstid);
-						if (dstIt != playersBySrcInstid.end()) {
-							Agent* stripper = dstIt->second;
-							const std::string& stripperTeam = stripper->team;
-							if (stripperTeam != "Unknown") {
-								bool vsPlayer = false;
-								// Now check the source agent (target) instead of destination
-								auto srcIt = agentsByInstid.find(event.srcInstid);
-								if (srcIt != agentsByInstid.end()) {
-									Agent* target = srcIt->second;
-									if (target->team != "Unknown") {
-										vsPlayer = true;
-									}
-								}
-								updateStats(result.teamStats[stripperTeam], stripper, 0, false, false,
-									vsPlayer, false, false, false, false, true);
-							}
-						}
-					}
-				}
-				// Handle damage and kills
-				else if (event.isBuffRemove == static_cast<uint8_t>(BuffRemove::None)) {
-					ResultCode resultCode = static_cast<ResultCode>(event.result);
-
-					if (resultCode == ResultCode::Normal || resultCode == ResultCode::Critical ||
-						resultCode == ResultCode::Glance || resultCode == ResultCode::KillingBlow) {
-
-						int32_t damageValue = 0;
-						bool isStrikeDamage = false;
-						bool isCondiDamage = false;
-
-						if (event.buff == 0) {
-							damageValue = event.value;
-							isStrikeDamage = true;
-						}
-						else if (event.buff == 1) {
-							damageValue = event.buffDmg;
-							isCondiDamage = true;
-						}
-
-						if (damageValue > 0) {
-							auto srcIt = playersBySrcInstid.find(event.srcInstid);
-							if (srcIt != playersBySrcInstid.end()) {
-								Agent* attacker = srcIt->second;
-								const std::string& attackerTeam = attacker->team;
-
-								if (attackerTeam != "Unknown") {
-									bool vsPlayer = false;
-									bool isDownedContribution = false;
-									bool isKillContribution = false;
-
-									auto dstIt = agentsByInstid.find(event.dstInstid);
-									if (dstIt != agentsByInstid.end()) {
-										Agent* target = dstIt->second;
-										if (target->team != "Unknown") {
-											vsPlayer = true;
-											auto stateIt = agentStates.find(target->address);
-											if (stateIt != agentStates.end()) {
-												isDownedContribution = isDamageInDownSequence(target, stateIt->second, event.time);
-												isKillContribution = isDamageInKillSequence(target, stateIt->second, event.time);
-											}
-										}
-									}
-
-									updateStats(result.teamStats[attackerTeam], attacker, damageValue, true, false,
-										vsPlayer, isStrikeDamage, isCondiDamage, isDownedContribution, isKillContribution, false);
-								}
-							}
-						}
-
-						// Process KillingBlow events
-						if (resultCode == ResultCode::KillingBlow) {
-							auto srcIt = playersBySrcInstid.find(event.srcInstid);
-							if (srcIt != playersBySrcInstid.end()) {
-								Agent* attacker = srcIt->second;
-								const std::string& attackerTeam = attacker->team;
-
-								if (attackerTeam != "Unknown") {
-									auto dstIt = agentsByInstid.find(event.dstInstid);
-									if (dstIt != agentsByInstid.end()) {
-										Agent* target = dstIt->second;
-										const std::string& targetTeam = target->team;
-
-										if (targetTeam != "Unknown") {
-											result.teamStats[targetTeam].totalDeathsFromKillingBlows++;
-											if (result.teamStats[targetTeam].isPOVTeam && target->subgroupNumber > 0) {
-												result.teamStats[targetTeam].squadStats.totalDeathsFromKillingBlows++;
-											}
-											updateStats(result.teamStats[attackerTeam], attacker, 0, false, true,
-												true, false, false, false, false, false);
-										}
-									}
-								}
-							}
-						}
-					}
-				}
-			}
+	// Process deaths, downs, damage, kills and strips
+	{
+		auto players = std::make_shared<PlayerStatsTable>();
+		assignPlayerRows(agentsByAddress, result, *players);
+		auto skillStats = std::make_shared<SkillStatsTable>();
+		const std::vector<uint32_t> skillGroupByPlayerRow = assignSkillGroups(*players, *skillStats);
+		SkillCounters skillCounters;
+		skillCounters.resize(skillStats->groups.size(), skills.size());
+
+		AccumulationContext context{ allEvents, streams, playersBySrcInstid, pass.agentsByInstid, pass.agentStates,
+			result.combatStartTime, TeamTimeline::getBucketCount(result.combatStartTime, result.combatEndTime),
+			skills, skillGroupByPlayerRow };
+		size_t threadCount = accumulation.threads != 0
+			? accumulation.threads
+			: chooseAccumulationThreads(allEvents.size(), settings);
+		auto rangeIndex = std::make_shared<FightRangeIndex>();
+		rangeIndex->setCombatRange(result.combatStartTime, result.combatEndTime);
+
+		auto accumulateStart = std::chrono::steady_clock::now();
+		accumulateCombatStats(context, result.teamStatsById, *rangeIndex, players->counters, skillCounters,
+			threadCount, token);
+		finishRangeIndex(*rangeIndex);
+		finishSkillStats(skillCounters, skills, *skillStats);
+		auto accumulateTime = std::chrono::steady_clock::now() - accumulateStart;
+		if (accumulation.elapsed) {
+			*accumulation.elapsed = accumulateTime;
+		}
+		else {
+			parseMetrics.accumulate.record(accumulateTime);
+		}
+		if (token.isCancelled()) {
+			return;
 		}
+		result.rangeIndex = std::move(rangeIndex);
+		result.players = std::move(players);
+		result.skills = std::move(skillStats);
 	}
 
 	if (settings.debugStringsMode) {
@@ -528,68 +301,34 @@ void parseCombatEvents(const std::vector<char>& bytes, size_t offset, size_t eve
 			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
 				("  instid=" + std::to_string(instid) +
 				 " addr=" + std::to_string(agent->address) +
-				 " team=" + agent->team +
+				 " team=" + std::to_string(agent->teamID) +
 				 " spec=" + agent->eliteSpec +
 				 " acct=" + agent->accountName).c_str());
 		}
 	}
 
-	std::unordered_map<std::string, std::unordered_set<std::string>> countedAccounts;
-	std::unordered_set<uint16_t> countedNonSquadInstids;
-
-	for (const auto& [addr, agent] : agentsByAddress) {
-		if (agent.team.empty() || agent.team == "Unknown") continue;
-
-		bool isSquad = agent.subgroupNumber > 0;
-
-		if (isSquad) {
-			if (!active_ptrs.count(addr)) continue;
-			if (!agent.accountName.empty() && agent.accountName[0] == ':') {
-				if (!countedAccounts[agent.team].insert(agent.accountName).second)
-					continue;
-			}
-		} else {
-			auto iit = ptr_to_instid.find(addr);
-			if (iit == ptr_to_instid.end()) continue;
-			if (!countedNonSquadInstids.insert(iit->second).second)
-				continue;
-		}
+	countPlayers(agentsByAddress, pass, result, settings);
 
-		auto& teamStats = result.teamStats[agent.team];
-		auto& specStats = teamStats.eliteSpecStats[agent.eliteSpec];
-
-		teamStats.totalPlayers++;
-		specStats.count++;
-		result.totalIdentifiedPlayers++;
-
-		if (settings.debugStringsMode) {
-			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
-				("COUNT: addr=" + std::to_string(addr) +
-				 " squad=" + std::to_string(isSquad) +
-				 " team=" + agent.team +
-				 " spec=" + agent.eliteSpec +
-				 " total=" + std::to_string(teamStats.totalPlayers)).c_str());
-		}
-
-		if (teamStats.isPOVTeam && isSquad) {
-			auto& squadStats = teamStats.squadStats;
-			squadStats.totalPlayers++;
-			squadStats.eliteSpecStats[agent.eliteSpec].count++;
-		}
-	}
+	resolveTeamStats(result, settings.teamIDs);
 
 	if (settings.debugStringsMode) {
 		for (const auto& [teamName, stats] : result.teamStats) {
 			APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
 				("FINAL: team=" + teamName + " totalPlayers=" + std::to_string(stats.totalPlayers)).c_str());
+			for (const auto& [skillId, strips] : stats.stripsBySkill) {
+				const char* skillName = getBoonStripSkillName(skillId);
+				APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME,
+					("  strips skill=" + std::string(skillName ? skillName : "other") +
+					 " count=" + std::to_string(strips)).c_str());
+			}
 		}
 	}
 }
 
-ParsedData parseEVTCFile(const std::filesystem::path& filePath, const ParserSettingsSnapshot& settings) {
+static ParsedData parseEVTCData(const char* data, size_t size, const ParserSettingsSnapshot& settings,
+	const AccumulationOptions& accumulation, const CancellationToken& token) {
 	ParsedData result;
-	std::vector<char> bytes = extractZipFile(filePath);
-	if (bytes.size() < 16) {
+	if (size < 16) {
 		APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME, "EVTC file is too small");
 		return result;
 	}
@@ -598,22 +337,22 @@ ParsedData parseEVTCFile(const std::filesystem::path& filePath, const ParserSett
 
 	// Read header (12 bytes)
 	char header[13] = { 0 };
-	std::memcpy(header, bytes.data() + offset, 12);
+	std::memcpy(header, data + offset, 12);
 	offset += 12;
 
 	// Read revision (1 byte)
 	uint8_t revision;
-	std::memcpy(&revision, bytes.data() + offset, sizeof(uint8_t));
+	std::memcpy(&revision, data + offset, sizeof(uint8_t));
 	offset += sizeof(uint8_t);
 
 	// Read fight instance ID (uint16_t)
 	uint16_t fightId;
-	std::memcpy(&fightId, bytes.data() + offset, sizeof(uint16_t));
+	std::memcpy(&fightId, data + offset, sizeof(uint16_t));
 	offset += sizeof(uint16_t);
 
 	// skip (1 byte)
 	uint8_t skipByte;
-	std::memcpy(&skipByte, bytes.data() + offset, sizeof(uint8_t));
+	std::memcpy(&skipByte, data + offset, sizeof(uint8_t));
 	offset += sizeof(uint8_t);
 
 	std::string headerStr(header);
@@ -641,46 +380,132 @@ ParsedData parseEVTCFile(const std::filesystem::path& filePath, const ParserSett
 	result.fightId = fightId;
 
 	// Read agent count (uint32_t)
-	if (offset + sizeof(uint32_t) > bytes.size()) {
+	if (offset + sizeof(uint32_t) > size) {
 		APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME, "Incomplete EVTC file: Missing agent count");
 		return result;
 	}
 	uint32_t agentCount;
-	std::memcpy(&agentCount, bytes.data() + offset, sizeof(uint32_t));
+	std::memcpy(&agentCount, data + offset, sizeof(uint32_t));
 	offset += sizeof(uint32_t);
 
 	std::unordered_map<uint64_t, Agent> agentsByAddress;
-	parseAgents(bytes, offset, agentCount, agentsByAddress);
+	parseAgents(data, size, offset, agentCount, agentsByAddress);
 
 	// Read skill count (uint32_t)
-	if (offset + sizeof(uint32_t) > bytes.size()) {
+	if (offset + sizeof(uint32_t) > size) {
 		APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME, "Incomplete EVTC file: Missing skill count");
 		return result;
 	}
 	uint32_t skillCount;
-	std::memcpy(&skillCount, bytes.data() + offset, sizeof(uint32_t));
+	std::memcpy(&skillCount, data + offset, sizeof(uint32_t));
 	offset += sizeof(uint32_t);
 
-	// Skip skills (68 bytes per skill)
-	size_t skillsSize = 68 * skillCount;
-	if (offset + skillsSize > bytes.size()) {
+	// Read skills (68 bytes per skill), interning their names
+	size_t skillsSize = 68 * static_cast<size_t>(skillCount);
+	if (offset + skillsSize > size) {
 		APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME, "Incomplete EVTC file: Skills data missing");
 		return result;
 	}
+	LogSkillTable skills = parseSkillTable(data + offset, skillCount, skillNamePool);
 	offset += skillsSize;
 
-	// Extract combat events
-	const size_t eventSize = sizeof(CombatEvent);
-	size_t remainingBytes = bytes.size() - offset;
-	size_t eventCount = remainingBytes / eventSize;
+	// View the combat events in place
+	CombatEventView events;
+	events.events = reinterpret_cast<const CombatEvent*>(data + offset);
+	events.count = (size - offset) / sizeof(CombatEvent);
 
 	// Process combat events
 	std::unordered_map<uint16_t, Agent*> playersBySrcInstid;
-	parseCombatEvents(bytes, offset, eventCount, agentsByAddress, playersBySrcInstid, result, settings);
+	parseCombatEvents(events, agentsByAddress, playersBySrcInstid, skills, result, settings, accumulation, token);
 
 	return result;
 }
 
+bool loadEVTCFile(const std::filesystem::path& filePath, BufferPool& pool, EVTCSource& source,
+	const CancellationToken& token) {
+	// Raw .evtc logs (arcdps compression disabled) are parsed straight out of
+	// a file mapping; .zevtc logs are inflated into a pooled buffer first.
+	source.kind = isCompressedEVTCFile(filePath) ? LogSourceKind::Compressed : LogSourceKind::Uncompressed;
+	ScopedLatency timer(parseMetrics.load[static_cast<size_t>(source.kind)]);
+
+	if (source.kind == LogSourceKind::Compressed) {
+		source.buffer = pool.acquire();
+		if (!extractZipFile(filePath, *source.buffer, token)) {
+			timer.dismiss();
+			return false;
+		}
+		source.data = source.buffer->data();
+		source.size = source.buffer->size();
+		return true;
+	}
+
+	if (!source.mapping.open(filePath)) {
+		timer.dismiss();
+		APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+			("Failed to map EVTC file: " + getUtf8Path(filePath)).c_str());
+		return false;
+	}
+	source.data = source.mapping.data();
+	source.size = source.mapping.size();
+	return true;
+}
+
+ParsedData parseEVTCSource(const EVTCSource& source, const ParserSettingsSnapshot& settings,
+	const CancellationToken& token, bool background) {
+	ScopedLatency timer(parseMetrics.parse[static_cast<size_t>(source.kind)]);
+	return parseEVTCData(source.data, source.size, settings, AccumulationOptions{ background ? 1u : 0u }, token);
+}
+
+std::vector<AccumulationBenchmarkRun> benchmarkAccumulation(const std::filesystem::path& filePath,
+	const ParserSettingsSnapshot& settings, const CancellationToken& token) {
+	constexpr size_t kThreadCounts[] = { 1, 2, 4, 8, 16 };
+	constexpr int kRepeats = 3;
+
+	std::vector<AccumulationBenchmarkRun> runs;
+	BufferPool pool(1, 0);
+	EVTCSource source;
+	if (!loadEVTCFile(filePath, pool, source, token)) {
+		return runs;
+	}
+
+	ParserSettingsSnapshot quietSettings = settings;
+	quietSettings.debugStringsMode = false;
+
+	ParsedData sequential;
+	for (size_t threads : kThreadCounts) {
+		AccumulationBenchmarkRun run;
+		run.threads = threads;
+		auto best = std::chrono::steady_clock::duration::max();
+		ParsedData data;
+		for (int repeat = 0; repeat < kRepeats; ++repeat) {
+			std::chrono::steady_clock::duration elapsed{};
+			data = parseEVTCData(source.data, source.size, quietSettings, AccumulationOptions{ threads, &elapsed }, token);
+			if (token.isCancelled()) {
+				return {};
+			}
+			best = std::min(best, elapsed);
+		}
+		run.milliseconds = std::chrono::duration<double, std::milli>(best).count();
+
+		if (threads == 1) {
+			sequential = std::move(data);
+		}
+		else {
+			run.matchesSequential = sameTeamStats(sequential.teamStatsById, data.teamStatsById);
+		}
+		runs.push_back(run);
+	}
+	return runs;
+}
+
+ParsedData parseEVTCFile(const std::filesystem::path& filePath, const ParserSettingsSnapshot& settings) {
+	EVTCSource source;
+	if (!loadEVTCFile(filePath, getDecompressionBufferPool(), source)) {
+		return ParsedData();
+	}
+	return parseEVTCSource(source, settings);
+}
+
 std::wstring getCanonicalPath(const std::filesystem::path& path)
 {
 	return std::filesystem::weakly_canonical(path).wstring();
@@ -4,6 +4,8 @@
 #include "shared/Shared.h"
 #include "utils/Utils.h"
 #include "parser/evtc_parser.h"
+#include "parser/buffer_pool.h"
+#include "parser/mapped_file.h"
 #include "thirdparty/miniz_cpp.hpp"
 #include <thread>
 #include <chrono>
@@ -32,23 +34,38 @@ std::string getUtf8Path(const std::filesystem::path& path) {
 }
 
 // File operation implementations
-std::vector<char> extractZipFile(const std::filesystem::path& filePath) {
+bool extractZipFile(const std::filesystem::path& filePath, std::vector<char>& output,
+    const CancellationToken& token) {
     try {
         std::string utf8Path = getUtf8Path(filePath);
         LogMessage(ELogLevel_DEBUG, ("Attempting to extract zip file: " + utf8Path).c_str());
 
+        // Inflate straight from a read-only mapping of the archive. If the
+        // file cannot be mapped, read it into a pooled buffer instead. Either
+        // way the compressed bytes only live until we return.
+        MappedFile mapping;
+        BufferPool::Lease input;
+
         miniz_cpp::zip_file zip;
-        if (!zip.load(filePath)) {
+        bool opened = false;
+        if (mapping.open(filePath)) {
+            opened = zip.load(mapping.data(), mapping.size());
+        }
+        else {
+            input = getDecompressionBufferPool().acquire();
+            opened = zip.load(filePath, *input);
+        }
+        if (!opened) {
             APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
                 ("Failed to open zip archive: " + utf8Path).c_str());
-            return {};
+            return false;
         }
 
         mz_uint numFiles = zip.get_num_files();
         if (numFiles == 0) {
             APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
                 "Zip archive contains no files.");
-            return {};
+            return false;
         }
 
         mz_zip_archive_file_stat fileStat{};
@@ -68,111 +85,55 @@ std::vector<char> extractZipFile(const std::filesystem::path& filePath) {
         if (targetIndex == MZ_UINT32_MAX) {
             APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
                 "Zip archive does not contain a valid file entry.");
-            return {};
+            return false;
         }
 
         if (fileStat.m_uncomp_size > 100 * 1024 * 1024) {
             APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
                 ("Uncompressed data too large: " + std::to_string(static_cast<unsigned long long>(fileStat.m_uncomp_size)) + " bytes").c_str());
-            return {};
+            return false;
         }
 
-        std::vector<char> result;
         try {
-            result = zip.read(targetIndex);
+            if (!zip.read(targetIndex, output, [&token] { return token.checkpoint(); })) {
+                LogMessage(ELogLevel_DEBUG, ("Extraction cancelled: " + utf8Path).c_str());
+                return false;
+            }
         }
         catch (const miniz_cpp::zip_exception& ex) {
             APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
                 ("Failed to extract file from zip archive: " + std::string(ex.what())).c_str());
-            return {};
+            return false;
         }
 
         LogMessage(ELogLevel_DEBUG, ("Successfully extracted zip file: " + utf8Path +
-            " (" + std::to_string(result.size()) + " bytes)").c_str());
+            " (" + std::to_string(output.size()) + " bytes)").c_str());
 
-        return result;
+        return true;
     }
     catch (const std::exception& e) {
         APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
             ("Unexpected error while extracting zip file: " + std::string(e.what())).c_str());
-        return std::vector<char>();
+        return false;
     }
 }
 
-void waitForFile(const std::filesystem::path& filePath) {
-    try {
-        std::string utf8Path = getUtf8Path(filePath);
-        LogMessage(ELogLevel_DEBUG, ("Starting to wait for file: " + utf8Path).c_str());
-
-        const int MAX_RETRIES = 30; // 15 seconds total max wait time
-        const int RETRY_DELAY_MS = 500;
-        int retries = 0;
-        DWORD previousSize = 0;
-        HANDLE hFile = INVALID_HANDLE_VALUE;
-
-        while (retries < MAX_RETRIES) {
-            try {
-                hFile = CreateFileW(
-                    filePath.wstring().c_str(),
-                    GENERIC_READ,
-                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-                    nullptr,
-                    OPEN_EXISTING,
-                    FILE_ATTRIBUTE_NORMAL,
-                    nullptr);
-
-                if (hFile == INVALID_HANDLE_VALUE) {
-                    DWORD error = GetLastError();
-                    if (error != ERROR_SHARING_VIOLATION) {
-                        LogMessage(ELogLevel_DEBUG, ("File not accessible, error code: " + std::to_string(error)).c_str());
-                    }
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                    retries++;
-                    continue;
-                }
-
-                DWORD currentSize = GetFileSize(hFile, nullptr);
-                if (currentSize == INVALID_FILE_SIZE) {
-                    DWORD error = GetLastError();
-                    APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-                        ("Failed to get file size, error code: " + std::to_string(error)).c_str());
-                    CloseHandle(hFile);
-                    retries++;
-                    continue;
-                }
-
-                if (currentSize == previousSize && currentSize > 0) {
-                    LogMessage(ELogLevel_DEBUG, ("File size stabilized at " + std::to_string(currentSize) + " bytes").c_str());
-                    CloseHandle(hFile);
-                    break;
-                }
-                LogMessage(ELogLevel_DEBUG, ("File size changed from " + std::to_string(previousSize) +
-                    " to " + std::to_string(currentSize) + " bytes").c_str());
-                previousSize = currentSize;
-                CloseHandle(hFile);
-                std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_DELAY_MS));
-                retries++;
-            }
-            catch (const std::exception& e) {
-                if (hFile != INVALID_HANDLE_VALUE) {
-                    CloseHandle(hFile);
-                }
-                APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-                    ("Error while checking file: " + std::string(e.what())).c_str());
-                throw;
-            }
-        }
-
-        if (retries >= MAX_RETRIES) {
-            APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-                ("Timeout waiting for file to stabilize: " + utf8Path).c_str());
-        }
-    }
-    catch (const std::exception& e) {
-        APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
-            ("Fatal error in waitForFile: " + std::string(e.what())).c_str());
-        throw;
+std::vector<char> extractZipFile(const std::filesystem::path& filePath) {
+    std::vector<char> result;
+    if (!extractZipFile(filePath, result)) {
+        return {};
     }
+    return result;
+}
+
+// arcdps writes .zevtc by default and plain .evtc with compression disabled
+bool isEVTCLogFile(const std::filesystem::path& filePath) {
+    const auto extension = filePath.extension();
+    return extension == L".zevtc" || extension == L".evtc";
+}
+
+bool isCompressedEVTCFile(const std::filesystem::path& filePath) {
+    return filePath.extension() == L".zevtc";
 }
 
 std::filesystem::path getArcPath()
@@ -250,7 +211,3 @@ std::vector<char> extractZipFile(const std::string& filePath) {
     return extractZipFile(std::filesystem::path(filePath));
 }
 
-void waitForFile(const std::string& filePath) {
-    waitForFile(std::filesystem::path(filePath));
-}
-
@@ -0,0 +1,197 @@
+#include "parser/file_watcher.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace {
+
+    class PollingFileWatcher : public FileWatcher {
+    public:
+        explicit PollingFileWatcher(size_t pollIntervalMilliseconds)
+            : interval(pollIntervalMilliseconds) {}
+
+        bool start(const std::filesystem::path&) override {
+            nextScan = std::chrono::steady_clock::now() + interval;
+            return true;
+        }
+
+        FileWatchStatus wait(std::chrono::milliseconds timeout, std::vector<FileWatchEvent>&) override {
+            auto now = std::chrono::steady_clock::now();
+            if (now < nextScan) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(nextScan - now);
+                std::unique_lock<std::mutex> lock(mutex);
+                if (wakeUp.wait_for(lock, std::min(timeout, remaining), [this] { return interrupted; })) {
+                    return FileWatchStatus::Timeout;
+                }
+                if (std::chrono::steady_clock::now() < nextScan) {
+                    return FileWatchStatus::Timeout;
+                }
+            }
+            nextScan = std::chrono::steady_clock::now() + interval;
+            return FileWatchStatus::RescanRequired;
+        }
+
+        void interrupt() override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                interrupted = true;
+            }
+            wakeUp.notify_all();
+        }
+
+        const char* getName() const override { return "polling"; }
+
+    private:
+        std::chrono::milliseconds interval;
+        std::chrono::steady_clock::time_point nextScan{};
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        bool interrupted = false;
+    };
+
+#ifdef _WIN32
+
+    class ReadDirectoryChangesWatcher : public FileWatcher {
+    public:
+        ReadDirectoryChangesWatcher()
+            : stopEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)) {}
+
+        ~ReadDirectoryChangesWatcher() override {
+            if (directory != INVALID_HANDLE_VALUE) {
+                CancelIoEx(directory, &overlapped);
+                DWORD ignored = 0;
+                GetOverlappedResult(directory, &overlapped, &ignored, TRUE);
+                CloseHandle(directory);
+            }
+            if (overlapped.hEvent) {
+                CloseHandle(overlapped.hEvent);
+            }
+            if (stopEvent) {
+                CloseHandle(stopEvent);
+            }
+        }
+
+        bool start(const std::filesystem::path& dirPath) override {
+            root = dirPath;
+            directory = CreateFileW(
+                dirPath.wstring().c_str(),
+                FILE_LIST_DIRECTORY,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                nullptr);
+            if (directory == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+
+            overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+            if (!overlapped.hEvent || !stopEvent) {
+                return false;
+            }
+
+            return issueRead();
+        }
+
+        FileWatchStatus wait(std::chrono::milliseconds timeout, std::vector<FileWatchEvent>& events) override {
+            const HANDLE handles[] = { overlapped.hEvent, stopEvent };
+            DWORD waitStatus = WaitForMultipleObjects(2, handles, FALSE, static_cast<DWORD>(timeout.count()));
+            if (waitStatus == WAIT_TIMEOUT || waitStatus == WAIT_OBJECT_0 + 1) {
+                return FileWatchStatus::Timeout;
+            }
+            if (waitStatus != WAIT_OBJECT_0) {
+                return FileWatchStatus::Failed;
+            }
+
+            DWORD bytesReturned = 0;
+            if (!GetOverlappedResult(directory, &overlapped, &bytesReturned, FALSE)) {
+                return GetLastError() == ERROR_NOTIFY_ENUM_DIR && issueRead()
+                    ? FileWatchStatus::RescanRequired
+                    : FileWatchStatus::Failed;
+            }
+
+            // Zero bytes means the kernel buffer overflowed and the changes
+            // were dropped; the caller has to rescan to catch up.
+            FileWatchStatus status = bytesReturned == 0 ? FileWatchStatus::RescanRequired : FileWatchStatus::Changes;
+            if (bytesReturned > 0) {
+                collectEvents(events);
+            }
+
+            if (!issueRead()) {
+                return FileWatchStatus::Failed;
+            }
+            return status;
+        }
+
+        void interrupt() override {
+            SetEvent(stopEvent);
+        }
+
+        const char* getName() const override { return "ReadDirectoryChangesW"; }
+
+    private:
+        bool issueRead() {
+            ResetEvent(overlapped.hEvent);
+            return ReadDirectoryChangesW(
+                directory,
+                buffer.data(),
+                static_cast<DWORD>(buffer.size()),
+                TRUE,
+                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE |
+                FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION,
+                nullptr,
+                &overlapped,
+                nullptr) != FALSE;
+        }
+
+        void collectEvents(std::vector<FileWatchEvent>& events) const {
+            const BYTE* cursor = buffer.data();
+            while (true) {
+                const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+
+                FileWatchEvent event;
+                event.path = root / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                switch (info->Action) {
+                case FILE_ACTION_ADDED: event.action = FileWatchEvent::Action::Added; break;
+                case FILE_ACTION_REMOVED: event.action = FileWatchEvent::Action::Removed; break;
+                case FILE_ACTION_RENAMED_OLD_NAME: event.action = FileWatchEvent::Action::Removed; break;
+                case FILE_ACTION_RENAMED_NEW_NAME: event.action = FileWatchEvent::Action::RenamedTo; break;
+                default: event.action = FileWatchEvent::Action::Modified; break;
+                }
+                events.push_back(std::move(event));
+
+                if (info->NextEntryOffset == 0) {
+                    break;
+                }
+                cursor += info->NextEntryOffset;
+            }
+        }
+
+        std::filesystem::path root;
+        HANDLE directory = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped{};
+        HANDLE stopEvent = nullptr;
+        // DWORD-aligned as ReadDirectoryChangesW requires
+        alignas(DWORD) std::array<BYTE, 64 * 1024> buffer{};
+    };
+
+#endif
+
+} // namespace
+
+std::unique_ptr<FileWatcher> createNativeFileWatcher() {
+#ifdef _WIN32
+    return std::make_unique<ReadDirectoryChangesWatcher>();
+#else
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<FileWatcher> createPollingFileWatcher(size_t pollIntervalMilliseconds) {
+    return std::make_unique<PollingFileWatcher>(pollIntervalMilliseconds);
+}
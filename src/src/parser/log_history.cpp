@@ -0,0 +1,331 @@
+#include "parser/log_history.h"
+#include "parser/statistics_helper.h"
+#include <algorithm>
+#include <set>
+
+LogHistory logHistory;
+
+namespace {
+    // A packed log is a few kilobytes, so a generous window still costs
+    // little and lets looser filters refill the history.
+    constexpr size_t kMaxDetailedLogs = 100;
+    // A range index runs to a few hundred kilobytes, so only the newest
+    // shown logs, as many as the view can show, keep theirs and their player
+    // and skill tables. Hidden logs that new keep theirs too, in case a
+    // filter is loosened.
+    constexpr size_t kMaxSharedDetailLogs = 20;
+
+    void addSpecCounts(LogSummary::Squad& squad, const std::unordered_map<std::string, SpecStats>& specStats) {
+        squad.specCounts.reserve(specStats.size());
+        for (const auto& [eliteSpec, stats] : specStats) {
+            squad.specCounts.emplace_back(eliteSpec, stats.count);
+        }
+    }
+
+    // newInstance is false when a second team ID of the same log resolves
+    // to a name already counted.
+    void addToAggregate(SquadAggregateStats& aggregate, const LogSummary::Squad& squad, bool newInstance) {
+        aggregate.totalPlayers += squad.totalPlayers;
+        aggregate.totalDeaths += squad.totalDeaths;
+        aggregate.totalDowned += squad.totalDowned;
+        if (newInstance) {
+            aggregate.instanceCount++;
+        }
+
+        for (const auto& [eliteSpec, count] : squad.specCounts) {
+            aggregate.eliteSpecTotals[eliteSpec].totalCount += count;
+        }
+    }
+}
+
+LogFilters LogFilters::fromSettings(const ParserSettingsSnapshot& settings) {
+    LogFilters filters;
+    filters.minTotalPlayers = settings.minTotalPlayers;
+    filters.minTotalDeaths = settings.minTotalDeaths;
+    filters.minTotalDowns = settings.minTotalDowns;
+    filters.minCombatDuration = settings.minCombatDuration;
+    return filters;
+}
+
+LogSummary LogSummary::fromParsedLog(const ParsedLog& log, bool live,
+    const std::unordered_map<int, std::string>& teamIDs) {
+    LogSummary summary;
+    summary.fileTime = log.fileTime;
+    if (log.data.combatEndTime > log.data.combatStartTime) {
+        summary.combatDuration = log.data.combatEndTime - log.data.combatStartTime;
+    }
+    summary.live = live;
+    summary.logTeamNames = log.data.logTeamNames;
+
+    summary.teams.reserve(log.data.teamStatsById.size());
+    for (const auto& [teamId, stats] : log.data.teamStatsById) {
+        Team team;
+        team.id = teamId;
+        team.isPOVTeam = stats.isPOVTeam;
+        team.totals.totalPlayers = stats.totalPlayers;
+        team.totals.totalDeaths = stats.totalDeaths;
+        team.totals.totalDowned = stats.totalDowned;
+        addSpecCounts(team.totals, stats.eliteSpecStats);
+        if (stats.isPOVTeam) {
+            team.povSquad.totalPlayers = stats.squadStats.totalPlayers;
+            team.povSquad.totalDeaths = stats.squadStats.totalDeaths;
+            team.povSquad.totalDowned = stats.squadStats.totalDowned;
+            addSpecCounts(team.povSquad, stats.squadStats.eliteSpecStats);
+        }
+        summary.teams.push_back(std::move(team));
+    }
+
+    summary.resolveTeams(teamIDs);
+    return summary;
+}
+
+void LogSummary::resolveTeams(const std::unordered_map<int, std::string>& teamIDs) {
+    totalPlayers = 0;
+    totalDeaths = 0;
+    totalDowns = 0;
+
+    for (auto& team : teams) {
+        team.name = resolveTeamName(team.id, logTeamNames, teamIDs);
+        if (team.name.empty()) {
+            continue;
+        }
+        totalPlayers += team.totals.totalPlayers;
+        totalDeaths += team.totals.totalDeaths;
+        totalDowns += team.totals.totalDowned;
+    }
+}
+
+size_t LogSummary::getMemoryUsage() const {
+    size_t total = sizeof(LogSummary) + teams.capacity() * sizeof(Team);
+    for (const auto& team : teams) {
+        total += team.name.capacity();
+        total += (team.totals.specCounts.capacity() + team.povSquad.specCounts.capacity()) *
+            sizeof(std::pair<std::string, uint32_t>);
+    }
+    total += logTeamNames.bucket_count() * sizeof(void*) +
+        logTeamNames.size() * (sizeof(std::pair<const uint32_t, std::string>) + 2 * sizeof(void*));
+    return total;
+}
+
+std::string getFilterMiss(const LogSummary& summary, const LogFilters& filters) {
+    if (filters.minTotalPlayers > 0 && summary.totalPlayers < static_cast<uint32_t>(filters.minTotalPlayers)) {
+        return "min total players (" + std::to_string(filters.minTotalPlayers) + "), has " +
+            std::to_string(summary.totalPlayers);
+    }
+    if (filters.minTotalDeaths > 0 && summary.totalDeaths < static_cast<uint32_t>(filters.minTotalDeaths)) {
+        return "min total deaths (" + std::to_string(filters.minTotalDeaths) + "), has " +
+            std::to_string(summary.totalDeaths);
+    }
+    if (filters.minTotalDowns > 0 && summary.totalDowns < static_cast<uint32_t>(filters.minTotalDowns)) {
+        return "min total downs (" + std::to_string(filters.minTotalDowns) + "), has " +
+            std::to_string(summary.totalDowns);
+    }
+    if (filters.minCombatDuration > 0 &&
+        summary.combatDuration < static_cast<uint64_t>(filters.minCombatDuration) * 1000) {
+        return "min combat duration (" + std::to_string(filters.minCombatDuration) + "s), has " +
+            std::to_string(summary.combatDuration / 1000.0) + "s";
+    }
+    return {};
+}
+
+bool LogHistory::add(const ParsedLog& log, bool live, const ParserSettingsSnapshot& settings) {
+    LogFilters filters = LogFilters::fromSettings(settings);
+    Entry entry;
+    entry.summary = LogSummary::fromParsedLog(log, live, settings.teamIDs);
+
+    std::string filterMiss = getFilterMiss(entry.summary, filters);
+    bool passes = filterMiss.empty();
+    if (!passes) {
+        APIDefs->Log(ELogLevel_DEBUG, ADDON_NAME, ("Hiding log below " + filterMiss + ": " + log.filename).c_str());
+    }
+    entry.log = PackedLog::pack(log);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    applyTeamIDs(settings.teamIDs);
+    viewFilters = filters;
+
+    // Workers can finish out of order, so insert by file time rather than
+    // at the front.
+    auto position = std::find_if(entries.begin(), entries.end(),
+        [&](const Entry& existing) { return existing.summary.fileTime < entry.summary.fileTime; });
+    entries.insert(position, std::move(entry));
+    trimDetails();
+
+    if (passes) {
+        // A new live log is shown straight away, as before; backlog fills in
+        // behind whatever is being looked at.
+        publishView(settings, live);
+    }
+    if (live) {
+        publishAggregates(filters);
+    }
+    return passes;
+}
+
+void LogHistory::refresh(const ParserSettingsSnapshot& settings) {
+    std::lock_guard<std::mutex> lock(mutex);
+    applyTeamIDs(settings.teamIDs);
+    viewFilters = LogFilters::fromSettings(settings);
+    trimDetails();
+    publishView(settings, false);
+    publishAggregates(viewFilters);
+}
+
+void LogHistory::resetAggregates() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : entries) {
+        entry.summary.live = false;
+    }
+    trimDetails();
+    publishAggregates(LogFilters{});
+}
+
+std::vector<uint32_t> LogHistory::getUnknownTeamIds() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::set<uint32_t> unknown;
+    for (const auto& entry : entries) {
+        for (const auto& team : entry.summary.teams) {
+            if (team.name.empty() && team.totals.totalPlayers > 0) {
+                unknown.insert(team.id);
+            }
+        }
+    }
+    return std::vector<uint32_t>(unknown.begin(), unknown.end());
+}
+
+void LogHistory::applyTeamIDs(const std::unordered_map<int, std::string>& newTeamIDs) {
+    if (newTeamIDs == teamIDs) {
+        return;
+    }
+    teamIDs = newTeamIDs;
+
+    // Only names change, so this is a lookup per team per log; packed logs
+    // are named when they are unpacked.
+    for (auto& entry : entries) {
+        entry.summary.resolveTeams(teamIDs);
+    }
+}
+
+LogHistory::MemoryUsage LogHistory::getMemoryUsage() {
+    std::lock_guard<std::mutex> lock(mutex);
+    MemoryUsage usage;
+    for (const auto& entry : entries) {
+        usage.summaries++;
+        usage.summaryBytes += entry.summary.getMemoryUsage();
+        if (entry.log) {
+            usage.packedLogs++;
+            usage.packedBytes += entry.log->getMemoryUsage();
+            if (size_t sharedBytes = entry.log->getSharedDetailsMemoryUsage()) {
+                usage.sharedDetailLogs++;
+                usage.sharedDetailBytes += sharedBytes;
+            }
+        }
+    }
+    return usage;
+}
+
+void LogHistory::trimDetails() {
+    size_t shown = 0;
+    for (size_t i = 0; i < entries.size() && i < kMaxDetailedLogs; ++i) {
+        if (!entries[i].log) {
+            continue;
+        }
+        if (getFilterMiss(entries[i].summary, viewFilters).empty()) {
+            if (++shown <= kMaxSharedDetailLogs) {
+                continue;
+            }
+        }
+        else if (i < kMaxSharedDetailLogs) {
+            continue;
+        }
+        entries[i].log->dropSharedDetails();
+    }
+    for (size_t i = kMaxDetailedLogs; i < entries.size(); ++i) {
+        entries[i].log.reset();
+    }
+
+    // A summary that is neither shown nor aggregated is no use to anyone.
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [](const Entry& entry) { return !entry.log && !entry.summary.live; }),
+        entries.end());
+}
+
+void LogHistory::publishView(const ParserSettingsSnapshot& settings, bool showNewest) const {
+    LogFilters filters = LogFilters::fromSettings(settings);
+
+    std::deque<ParsedLog> view;
+    for (const auto& entry : entries) {
+        if (view.size() >= settings.logHistorySize) {
+            break;
+        }
+        if (entry.log && getFilterMiss(entry.summary, filters).empty()) {
+            view.push_back(entry.log->unpack(teamIDs));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(parsedLogsMutex);
+    int selected = 0;
+    if (!showNewest && currentLogIndex >= 0 && currentLogIndex < static_cast<int>(parsedLogs.size())) {
+        const std::string& filename = parsedLogs[currentLogIndex].filename;
+        auto it = std::find_if(view.begin(), view.end(),
+            [&](const ParsedLog& log) { return log.filename == filename; });
+        if (it != view.end()) {
+            selected = static_cast<int>(it - view.begin());
+        }
+    }
+    parsedLogs = std::move(view);
+    currentLogIndex = selected;
+    parsedLogsRevision.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogHistory::publishAggregates(const LogFilters& filters) const {
+    GlobalAggregateStats stats;
+    for (const auto& entry : entries) {
+        if (!entry.summary.live || !getFilterMiss(entry.summary, filters).empty()) {
+            continue;
+        }
+
+        stats.totalCombatTime += entry.summary.combatDuration;
+        stats.combatInstanceCount++;
+
+        std::vector<const std::string*> countedTeams;
+        for (const auto& team : entry.summary.teams) {
+            if (team.name.empty()) {
+                continue;
+            }
+            bool newInstance = std::none_of(countedTeams.begin(), countedTeams.end(),
+                [&](const std::string* counted) { return *counted == team.name; });
+            countedTeams.push_back(&team.name);
+
+            auto& teamAgg = stats.teamAggregates[team.name];
+            addToAggregate(teamAgg.teamTotals, team.totals, newInstance);
+            if (team.isPOVTeam) {
+                // Only the POV's own team ID carries a squad.
+                teamAgg.isPOVTeam = true;
+                addToAggregate(teamAgg.povSquadTotals, team.povSquad, true);
+            }
+        }
+    }
+
+    CachedAverages averages;
+    averages.averageCombatTime = stats.getAverageCombatTime();
+    for (const auto& [teamName, teamAgg] : stats.teamAggregates) {
+        // Full team averages
+        averages.averageTeamPlayerCounts[teamName] = teamAgg.getAverageTeamPlayerCount();
+        for (const auto& [specName, _] : teamAgg.teamTotals.eliteSpecTotals) {
+            averages.averageTeamSpecCounts[teamName][specName] = teamAgg.getAverageTeamSpecCount(specName);
+        }
+
+        // POV squad averages if POV
+        if (teamAgg.isPOVTeam) {
+            averages.averagePOVSquadPlayerCounts[teamName] = teamAgg.getAveragePOVSquadPlayerCount();
+            for (const auto& [specName, _] : teamAgg.povSquadTotals.eliteSpecTotals) {
+                averages.averagePOVSquadSpecCounts[teamName][specName] = teamAgg.getAveragePOVSquadSpecCount(specName);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(aggregateStatsMutex);
+    globalAggregateStats = std::move(stats);
+    cachedAverages = std::move(averages);
+}
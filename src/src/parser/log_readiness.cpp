@@ -0,0 +1,125 @@
+#include "parser/log_readiness.h"
+#include "parser/file_helpers.h"
+#include "parser/mapped_file.h"
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace {
+    constexpr uint32_t kEndOfCentralDirSignature = 0x06054b50;
+    constexpr uint32_t kCentralHeaderSignature = 0x02014b50;
+    constexpr uint32_t kLocalHeaderSignature = 0x04034b50;
+    constexpr size_t kEndOfCentralDirSize = 22;
+    constexpr size_t kCentralHeaderSize = 46;
+    constexpr size_t kLocalHeaderSize = 30;
+    constexpr size_t kMaxCommentSize = 0xFFFF;
+
+    uint16_t readU16(const char* p) {
+        uint16_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t readU32(const char* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+#ifdef _WIN32
+    // Withholding write sharing is the probe itself: the open fails with a
+    // sharing violation while anyone has the file open for writing. Read and
+    // delete stay shared, and the handle is closed at once, so a writer that
+    // reopens or a cleaner that deletes is never turned away for long. Any
+    // other failure will not clear up by waiting.
+    LogReadiness probeWriter(const std::filesystem::path& filePath) {
+        HANDLE file = CreateFileW(
+            filePath.wstring().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return GetLastError() == ERROR_SHARING_VIOLATION
+                ? LogReadiness::Writing
+                : LogReadiness::Unreadable;
+        }
+        CloseHandle(file);
+        return LogReadiness::Ready;
+    }
+#endif
+}
+
+bool hasCompleteZipDirectory(const char* data, size_t size) {
+    if (size < kEndOfCentralDirSize) {
+        return false;
+    }
+
+    // arcdps writes no archive comment, so the record is normally the last
+    // 22 bytes; still scan back over a possible comment to be safe.
+    size_t lowest = size > kEndOfCentralDirSize + kMaxCommentSize ? size - kEndOfCentralDirSize - kMaxCommentSize : 0;
+    for (size_t pos = size - kEndOfCentralDirSize + 1; pos-- > lowest;) {
+        const char* eocd = data + pos;
+        if (readU32(eocd) != kEndOfCentralDirSignature) {
+            continue;
+        }
+
+        uint16_t entryCount = readU16(eocd + 10);
+        uint32_t centralDirSize = readU32(eocd + 12);
+        uint32_t centralDirOffset = readU32(eocd + 16);
+        if (entryCount == 0 ||
+            static_cast<uint64_t>(centralDirOffset) + centralDirSize > pos ||
+            centralDirSize < kCentralHeaderSize) {
+            return false;
+        }
+
+        const char* central = data + centralDirOffset;
+        if (readU32(central) != kCentralHeaderSignature) {
+            return false;
+        }
+        uint32_t compressedSize = readU32(central + 20);
+        uint32_t localHeaderOffset = readU32(central + 42);
+
+        if (static_cast<uint64_t>(localHeaderOffset) + kLocalHeaderSize > centralDirOffset) {
+            return false;
+        }
+        const char* local = data + localHeaderOffset;
+        if (readU32(local) != kLocalHeaderSignature) {
+            return false;
+        }
+        uint64_t dataEnd = static_cast<uint64_t>(localHeaderOffset) + kLocalHeaderSize +
+            readU16(local + 26) + readU16(local + 28) + compressedSize;
+        return dataEnd <= centralDirOffset;
+    }
+    return false;
+}
+
+LogReadiness checkLogReadiness(const std::filesystem::path& filePath) {
+#ifdef _WIN32
+    LogReadiness writer = probeWriter(filePath);
+    if (writer != LogReadiness::Ready) {
+        return writer;
+    }
+#endif
+
+    if (!isCompressedEVTCFile(filePath)) {
+#ifdef _WIN32
+        return LogReadiness::Ready;
+#else
+        return LogReadiness::Unknown;
+#endif
+    }
+
+    MappedFile mapping;
+    if (!mapping.open(filePath)) {
+        return LogReadiness::Writing;
+    }
+    return hasCompleteZipDirectory(mapping.data(), mapping.size())
+        ? LogReadiness::Ready
+        : LogReadiness::Writing;
+}
@@ -0,0 +1,413 @@
+#include "parser/packed_log.h"
+#include "parser/statistics_helper.h"
+#include <mutex>
+
+namespace {
+    constexpr uint32_t SpecStats::* kSpecCounters32[] = {
+        &SpecStats::count,
+        &SpecStats::totalKills,
+        &SpecStats::totalKillsVsPlayers,
+        &SpecStats::totalDeaths,
+        &SpecStats::totalDowned,
+    };
+
+    constexpr uint64_t SpecStats::* kSpecCounters64[] = {
+        &SpecStats::totalDamage,
+        &SpecStats::totalStrips,
+        &SpecStats::totalStripsVsPlayers,
+        &SpecStats::totalStrikeDamage,
+        &SpecStats::totalCondiDamage,
+        &SpecStats::totalDamageVsPlayers,
+        &SpecStats::totalStrikeDamageVsPlayers,
+        &SpecStats::totalCondiDamageVsPlayers,
+        &SpecStats::totalDownedContribution,
+        &SpecStats::totalDownedContributionVsPlayers,
+        &SpecStats::totalKillContribution,
+        &SpecStats::totalKillContributionVsPlayers,
+    };
+
+    constexpr size_t kCounters32 = sizeof(kSpecCounters32) / sizeof(kSpecCounters32[0]);
+    constexpr size_t kCounters64 = sizeof(kSpecCounters64) / sizeof(kSpecCounters64[0]);
+
+    // Spec names interned to dense indices. The set of specs is small and
+    // fixed for the session, so the table only ever grows by a few entries.
+    std::mutex specTableMutex;
+    std::vector<std::string> specNames;
+    std::unordered_map<std::string, uint32_t> specIndices;
+
+    uint32_t getSpecIndex(const std::string& specName) {
+        std::lock_guard<std::mutex> lock(specTableMutex);
+        auto [it, inserted] = specIndices.try_emplace(specName, static_cast<uint32_t>(specNames.size()));
+        if (inserted) {
+            specNames.push_back(specName);
+        }
+        return it->second;
+    }
+
+    std::string getSpecName(uint32_t index) {
+        std::lock_guard<std::mutex> lock(specTableMutex);
+        return index < specNames.size() ? specNames[index] : std::string();
+    }
+
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint64_t readVarint(const uint8_t*& in) {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = *in++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+    }
+
+    uint32_t getCounterMask(const SpecStats& stats) {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kCounters32; ++i) {
+            if (stats.*kSpecCounters32[i] != 0) {
+                mask |= 1u << i;
+            }
+        }
+        for (size_t i = 0; i < kCounters64; ++i) {
+            if (stats.*kSpecCounters64[i] != 0) {
+                mask |= 1u << (kCounters32 + i);
+            }
+        }
+        return mask;
+    }
+
+    // Writes one row: its key, the mask and the counters the mask names.
+    void writeRow(std::vector<uint8_t>& out, uint32_t key, uint32_t mask, const SpecStats& stats) {
+        writeVarint(out, key);
+        writeVarint(out, mask);
+        for (size_t i = 0; i < kCounters32; ++i) {
+            if (mask & (1u << i)) {
+                writeVarint(out, stats.*kSpecCounters32[i]);
+            }
+        }
+        for (size_t i = 0; i < kCounters64; ++i) {
+            if (mask & (1u << (kCounters32 + i))) {
+                writeVarint(out, stats.*kSpecCounters64[i]);
+            }
+        }
+    }
+
+    // Reads the counters of a row whose key has been read.
+    void readRowCounters(const uint8_t*& in, SpecStats& stats) {
+        uint32_t mask = static_cast<uint32_t>(readVarint(in));
+        for (size_t i = 0; i < kCounters32; ++i) {
+            if (mask & (1u << i)) {
+                stats.*kSpecCounters32[i] = static_cast<uint32_t>(readVarint(in));
+            }
+        }
+        for (size_t i = 0; i < kCounters64; ++i) {
+            if (mask & (1u << (kCounters32 + i))) {
+                stats.*kSpecCounters64[i] = readVarint(in);
+            }
+        }
+    }
+
+    uint16_t writeSpecRows(std::vector<uint8_t>& out, const std::unordered_map<std::string, SpecStats>& specs) {
+        for (const auto& [specName, stats] : specs) {
+            writeRow(out, getSpecIndex(specName), getCounterMask(stats), stats);
+        }
+        return static_cast<uint16_t>(specs.size());
+    }
+
+    // Decodes rows into the spec map and adds each one into the totals,
+    // which is how the parser built those totals in the first place.
+    template <typename Stats>
+    void readSpecRows(const uint8_t*& in, uint16_t rowCount, Stats& totals) {
+        for (uint16_t row = 0; row < rowCount; ++row) {
+            SpecStats& stats = totals.eliteSpecStats[getSpecName(static_cast<uint32_t>(readVarint(in)))];
+            readRowCounters(in, stats);
+
+            totals.totalPlayers += stats.count;
+            addSpecCounters(totals, stats);
+        }
+    }
+
+    // Parties are keyed by their index and only written when not all zero.
+    uint8_t writeSubgroupRows(std::vector<uint8_t>& out, const SquadStats& squad) {
+        uint8_t rowCount = 0;
+        for (size_t i = 0; i < kMaxSubgroups; ++i) {
+            uint32_t mask = getCounterMask(squad.subgroupStats[i]);
+            if (mask != 0) {
+                writeRow(out, static_cast<uint32_t>(i), mask, squad.subgroupStats[i]);
+                ++rowCount;
+            }
+        }
+        return rowCount;
+    }
+
+    void readSubgroupRows(const uint8_t*& in, uint8_t rowCount, SquadStats& squad) {
+        for (uint8_t row = 0; row < rowCount; ++row) {
+            size_t index = static_cast<size_t>(readVarint(in));
+            SpecStats unused;
+            readRowCounters(in, index < kMaxSubgroups ? squad.subgroupStats[index] : unused);
+        }
+    }
+
+    uint8_t writeStripSkillRows(std::vector<uint8_t>& out, const std::unordered_map<uint32_t, uint32_t>& stripsBySkill) {
+        for (const auto& [skillId, strips] : stripsBySkill) {
+            writeVarint(out, skillId);
+            writeVarint(out, strips);
+        }
+        return static_cast<uint8_t>(stripsBySkill.size());
+    }
+
+    void readStripSkillRows(const uint8_t*& in, uint8_t rowCount, std::unordered_map<uint32_t, uint32_t>& stripsBySkill) {
+        for (uint8_t row = 0; row < rowCount; ++row) {
+            uint32_t skillId = static_cast<uint32_t>(readVarint(in));
+            stripsBySkill[skillId] = static_cast<uint32_t>(readVarint(in));
+        }
+    }
+
+    // Writes the count of non-zero buckets, then each one's gap from the
+    // last and its value.
+    template <typename T>
+    void writeSeries(std::vector<uint8_t>& out, const std::vector<T>& series) {
+        uint64_t nonZero = 0;
+        for (T value : series) {
+            nonZero += value != 0;
+        }
+        writeVarint(out, nonZero);
+
+        size_t next = 0;
+        for (size_t i = 0; i < series.size(); ++i) {
+            if (series[i] != 0) {
+                writeVarint(out, i - next);
+                writeVarint(out, series[i]);
+                next = i + 1;
+            }
+        }
+    }
+
+    // Reads a series written by writeSeries into one already sized.
+    template <typename T>
+    void readSeries(const uint8_t*& in, std::vector<T>& series) {
+        uint64_t nonZero = readVarint(in);
+        size_t next = 0;
+        for (uint64_t i = 0; i < nonZero; ++i) {
+            size_t bucket = next + static_cast<size_t>(readVarint(in));
+            T value = static_cast<T>(readVarint(in));
+            if (bucket < series.size()) {
+                series[bucket] = value;
+            }
+            next = bucket + 1;
+        }
+    }
+
+    void writeTimeline(std::vector<uint8_t>& out, const TeamTimeline& timeline) {
+        writeSeries(out, timeline.damage);
+        writeSeries(out, timeline.damageVsPlayers);
+        writeSeries(out, timeline.downs);
+        writeSeries(out, timeline.deaths);
+        writeSeries(out, timeline.strips);
+        writeSeries(out, timeline.players);
+    }
+
+    void readTimeline(const uint8_t*& in, uint16_t bucketCount, TeamTimeline& timeline) {
+        timeline.resize(bucketCount);
+        readSeries(in, timeline.damage);
+        readSeries(in, timeline.damageVsPlayers);
+        readSeries(in, timeline.downs);
+        readSeries(in, timeline.deaths);
+        readSeries(in, timeline.strips);
+        readSeries(in, timeline.players);
+    }
+
+    template <typename Map>
+    size_t estimateMapOverhead(const Map& map) {
+        return map.bucket_count() * sizeof(void*) +
+            map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void*));
+    }
+
+    size_t estimateTimelineUsage(const TeamTimeline& timeline) {
+        return timeline.damage.capacity() * sizeof(uint32_t) +
+            timeline.damageVsPlayers.capacity() * sizeof(uint32_t) +
+            (timeline.downs.capacity() + timeline.deaths.capacity() + timeline.strips.capacity() +
+            timeline.players.capacity()) * sizeof(uint16_t);
+    }
+
+    size_t estimateSpecMapUsage(const std::unordered_map<std::string, SpecStats>& specs) {
+        size_t total = estimateMapOverhead(specs);
+        for (const auto& [specName, _] : specs) {
+            total += specName.capacity();
+        }
+        return total;
+    }
+}
+
+PackedLog PackedLog::pack(const ParsedLog& log) {
+    PackedLog packed;
+    packed.filename = log.filename;
+    packed.fileTime = log.fileTime;
+    packed.combatStartTime = log.data.combatStartTime;
+    packed.combatEndTime = log.data.combatEndTime;
+    packed.logStartUnix = log.data.logStartUnix;
+    packed.logEndUnix = log.data.logEndUnix;
+    packed.fightId = log.data.fightId;
+    packed.logTeamNames.assign(log.data.logTeamNames.begin(), log.data.logTeamNames.end());
+    packed.rangeIndex = log.data.rangeIndex;
+    packed.players = log.data.players;
+    packed.skills = log.data.skills;
+
+    std::vector<uint8_t> timelines;
+    packed.teams.reserve(log.data.teamStatsById.size());
+    for (const auto& [teamId, stats] : log.data.teamStatsById) {
+        Team team;
+        team.id = teamId;
+        team.isPOVTeam = stats.isPOVTeam;
+        team.deathsFromKillingBlows = stats.totalDeathsFromKillingBlows;
+        team.squadDeathsFromKillingBlows = stats.squadStats.totalDeathsFromKillingBlows;
+        team.timeWeightedPlayers = stats.timeWeightedPlayers;
+        team.squadTimeWeightedPlayers = stats.squadStats.timeWeightedPlayers;
+        team.specRows = writeSpecRows(packed.specRows, stats.eliteSpecStats);
+        team.squadSpecRows = writeSpecRows(packed.specRows, stats.squadStats.eliteSpecStats);
+        team.subgroupRows = writeSubgroupRows(packed.specRows, stats.squadStats);
+        team.stripSkillRows = writeStripSkillRows(packed.specRows, stats.stripsBySkill);
+        team.timelineBuckets = static_cast<uint16_t>(stats.timeline.size());
+        if (!stats.timeline.empty()) {
+            writeTimeline(timelines, stats.timeline);
+        }
+        packed.teams.push_back(team);
+    }
+
+    packed.specRows.shrink_to_fit();
+    if (!timelines.empty()) {
+        timelines.shrink_to_fit();
+        packed.timelines = std::make_shared<const std::vector<uint8_t>>(std::move(timelines));
+    }
+    return packed;
+}
+
+ParsedLog PackedLog::unpack(const std::unordered_map<int, std::string>& teamIDs) const {
+    ParsedLog log;
+    log.filename = filename;
+    log.fileTime = fileTime;
+    log.data.combatStartTime = combatStartTime;
+    log.data.combatEndTime = combatEndTime;
+    log.data.logStartUnix = logStartUnix;
+    log.data.logEndUnix = logEndUnix;
+    log.data.fightId = fightId;
+    log.data.logTeamNames.insert(logTeamNames.begin(), logTeamNames.end());
+    log.data.rangeIndex = rangeIndex;
+    log.data.players = players;
+    log.data.skills = skills;
+
+    const uint8_t* in = specRows.data();
+    // Null once the shared details were dropped; the teams then go without
+    const uint8_t* timelineIn = timelines ? timelines->data() : nullptr;
+    for (const auto& team : teams) {
+        TeamStats& stats = log.data.teamStatsById[team.id];
+        stats.isPOVTeam = team.isPOVTeam;
+        stats.totalDeathsFromKillingBlows = team.deathsFromKillingBlows;
+        stats.squadStats.totalDeathsFromKillingBlows = team.squadDeathsFromKillingBlows;
+        stats.timeWeightedPlayers = team.timeWeightedPlayers;
+        stats.squadStats.timeWeightedPlayers = team.squadTimeWeightedPlayers;
+        readSpecRows(in, team.specRows, stats);
+        readSpecRows(in, team.squadSpecRows, stats.squadStats);
+        readSubgroupRows(in, team.subgroupRows, stats.squadStats);
+        readStripSkillRows(in, team.stripSkillRows, stats.stripsBySkill);
+        if (timelineIn && team.timelineBuckets != 0) {
+            readTimeline(timelineIn, team.timelineBuckets, stats.timeline);
+        }
+    }
+
+    resolveTeamStats(log.data, teamIDs);
+    return log;
+}
+
+size_t PackedLog::getMemoryUsage() const {
+    size_t total = sizeof(PackedLog) + filename.capacity() +
+        teams.capacity() * sizeof(Team) + specRows.capacity() +
+        logTeamNames.capacity() * sizeof(logTeamNames[0]);
+    for (const auto& [_, name] : logTeamNames) {
+        total += name.capacity();
+    }
+    return total;
+}
+
+size_t PackedLog::getSharedDetailsMemoryUsage() const {
+    size_t total = 0;
+    if (timelines) {
+        total += sizeof(*timelines) + timelines->capacity();
+    }
+    if (rangeIndex) {
+        total += estimateMemoryUsage(*rangeIndex);
+    }
+    if (players) {
+        total += estimateMemoryUsage(*players);
+    }
+    if (skills) {
+        total += estimateMemoryUsage(*skills);
+    }
+    return total;
+}
+
+size_t estimateMemoryUsage(const ParsedData& data) {
+    size_t total = sizeof(ParsedData);
+
+    auto addTeams = [&total](const auto& teamMap) {
+        total += estimateMapOverhead(teamMap);
+        for (const auto& [_, stats] : teamMap) {
+            total += estimateSpecMapUsage(stats.eliteSpecStats);
+            total += estimateSpecMapUsage(stats.squadStats.eliteSpecStats);
+            total += estimateTimelineUsage(stats.timeline);
+            total += estimateMapOverhead(stats.stripsBySkill);
+        }
+    };
+    addTeams(data.teamStatsById);
+    addTeams(data.teamStats);
+    for (const auto& [teamName, _] : data.teamStats) {
+        total += teamName.capacity();
+    }
+
+    total += estimateMapOverhead(data.logTeamNames);
+    return total;
+}
+
+size_t estimateMemoryUsage(const FightRangeIndex& index) {
+    size_t total = sizeof(FightRangeIndex) + estimateMapOverhead(index.teams);
+    for (const auto& [_, team] : index.teams) {
+        for (const FightRangeIndex::Squad* squad : { &team.totals, &team.povSquad }) {
+            total += estimateMapOverhead(squad->specs);
+            for (const auto& [specName, rows] : squad->specs) {
+                total += specName.capacity() + rows.capacity() * sizeof(SpecCounters);
+            }
+            total += squad->deathsFromKillingBlows.capacity() * sizeof(uint32_t);
+        }
+    }
+    return total;
+}
+
+size_t estimateMemoryUsage(const PlayerStatsTable& table) {
+    size_t total = sizeof(PlayerStatsTable) +
+        table.names.capacity() * sizeof(std::string) +
+        table.eliteSpecs.capacity() * sizeof(std::string) +
+        table.teamIDs.capacity() * sizeof(uint32_t) +
+        table.inSquad.capacity();
+    for (size_t row = 0; row < table.size(); ++row) {
+        total += table.names[row].capacity() + table.eliteSpecs[row].capacity();
+    }
+    for (const auto& column : table.counters.columns) {
+        total += column.capacity() * sizeof(uint64_t);
+    }
+    return total;
+}
+
+size_t estimateMemoryUsage(const SkillStatsTable& table) {
+    size_t total = sizeof(SkillStatsTable) + table.groups.capacity() * sizeof(SkillStatsTable::Group);
+    for (const auto& group : table.groups) {
+        total += group.eliteSpec.capacity() + group.skills.capacity() * sizeof(SkillTotals);
+    }
+    return total;
+}
@@ -0,0 +1,54 @@
+#include "parser/parse_metrics.h"
+
+ParseMetrics parseMetrics;
+
+void LatencyStat::record(std::chrono::steady_clock::duration elapsed) {
+    uint64_t micros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t previousMax = maxMicros.load(std::memory_order_relaxed);
+    while (micros > previousMax &&
+        !maxMicros.compare_exchange_weak(previousMax, micros, std::memory_order_relaxed)) {
+    }
+}
+
+double LatencyStat::getAverageMilliseconds() const {
+    uint64_t samples = count.load(std::memory_order_relaxed);
+    if (samples == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(totalMicros.load(std::memory_order_relaxed)) / samples / 1000.0;
+}
+
+double LatencyStat::getMaxMilliseconds() const {
+    return static_cast<double>(maxMicros.load(std::memory_order_relaxed)) / 1000.0;
+}
+
+void LatencyStat::reset() {
+    count.store(0, std::memory_order_relaxed);
+    totalMicros.store(0, std::memory_order_relaxed);
+    maxMicros.store(0, std::memory_order_relaxed);
+}
+
+void ParseMetrics::reset() {
+    for (auto& stat : load) {
+        stat.reset();
+    }
+    for (auto& stat : parse) {
+        stat.reset();
+    }
+    accumulate.reset();
+    readiness.reset();
+    detectionToPublish.reset();
+    monitorShutdown.reset();
+    combatThrottle.reset();
+    idleFrames.reset();
+    combatIdleFrames.reset();
+    parsingFrames.reset();
+    for (auto& stat : combatParsingFrames) {
+        stat.reset();
+    }
+}
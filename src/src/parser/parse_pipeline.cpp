@@ -0,0 +1,176 @@
+#include "parser/parse_pipeline.h"
+#include "parser/file_helpers.h"
+#include "parser/parse_scheduler.h"
+#include "settings/Settings.h"
+#include <algorithm>
+
+namespace {
+    // Descriptors only, so the discovery queue can be generous.
+    constexpr size_t kJobQueueCapacity = 256;
+    constexpr size_t kMaxRetainedPipelineBytes = 64 * 1024 * 1024;
+
+    size_t toLane(LogPriority priority) {
+        return static_cast<size_t>(priority);
+    }
+}
+
+ParsePipeline::ParsePipeline(size_t workerCount, PublishFn publish, FinishFn finish)
+    : publish(std::move(publish)),
+    finish(std::move(finish)),
+    // One inflated buffer per worker in flight plus one queued per worker.
+    bufferPool(2 * std::max<size_t>(workerCount, 1), kMaxRetainedPipelineBytes),
+    jobs(kJobQueueCapacity),
+    loadedLogs(std::max<size_t>(workerCount, 1)),
+    parsedLogResults(2 * std::max<size_t>(workerCount, 1)) {
+    workerCount = std::max<size_t>(workerCount, 1);
+
+    for (size_t i = 0; i < workerCount; ++i) {
+        inflateThreads.emplace_back(&ParsePipeline::runInflateStage, this);
+        parseThreads.emplace_back(&ParsePipeline::runParseStage, this);
+    }
+    publishThread = std::thread(&ParsePipeline::runPublishStage, this);
+}
+
+ParsePipeline::~ParsePipeline() {
+    stop();
+}
+
+bool ParsePipeline::submit(LogJob job) {
+    if (cancelled) {
+        return false;
+    }
+    LogPriority priority = job.priority;
+    return jobs.push(std::move(job), toLane(priority));
+}
+
+void ParsePipeline::cancel() {
+    cancelled = true;
+
+    // Closing wakes every blocked push and pop; clearing hands the buffers
+    // of logs that never got parsed straight back.
+    jobs.close();
+    jobs.clear();
+    loadedLogs.close();
+    loadedLogs.clear();
+    parsedLogResults.close();
+    parsedLogResults.clear();
+}
+
+void ParsePipeline::stop() {
+    if (stopped) {
+        return;
+    }
+    stopped = true;
+
+    cancel();
+    for (auto& thread : inflateThreads) {
+        thread.join();
+    }
+    for (auto& thread : parseThreads) {
+        thread.join();
+    }
+    publishThread.join();
+
+    inflateThreads.clear();
+    parseThreads.clear();
+}
+
+size_t ParsePipeline::getQueuedCount() const {
+    return jobs.size() + loadedLogs.size() + parsedLogResults.size();
+}
+
+size_t ParsePipeline::getRetainedBufferBytes() const {
+    return bufferPool.retainedBytes();
+}
+
+void ParsePipeline::finishJob(const LogJob& job) {
+    if (!finish) {
+        return;
+    }
+    try {
+        finish(job);
+    }
+    catch (const std::exception& ex) {
+        APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+            ("Exception finishing log: " + std::string(ex.what())).c_str());
+    }
+}
+
+void ParsePipeline::runInflateStage() {
+    while (auto job = jobs.pop()) {
+        try {
+            LoadedLog loaded{ *job, EVTCSource{} };
+            bool loadedOk = false;
+            {
+                ParseScheduler::BusyScope busy(parseScheduler);
+                loadedOk = loadEVTCFile(loaded.job.path, bufferPool, loaded.source,
+                    CancellationToken(cancelled, &parseScheduler));
+            }
+            if (cancelled) {
+                break;
+            }
+            // loadEVTCFile has logged why; there is nothing to parse.
+            if (!loadedOk) {
+                finishJob(loaded.job);
+                continue;
+            }
+
+            LogPriority priority = loaded.job.priority;
+            loadedLogs.push(std::move(loaded), toLane(priority));
+        }
+        catch (const std::exception& ex) {
+            APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+                ("Exception loading log: " + std::string(ex.what())).c_str());
+            finishJob(*job);
+        }
+    }
+}
+
+void ParsePipeline::runParseStage() {
+    while (auto loaded = loadedLogs.pop()) {
+        // Kept for finishing the job if the parse throws.
+        const LogJob job = loaded->job;
+        try {
+            ParsedLogResult result;
+            result.job = job;
+            result.log.filename = getUtf8Path(result.job.path.filename());
+            result.log.fileTime = result.job.lastWriteTime;
+            {
+                ParseScheduler::BusyScope busy(parseScheduler);
+                result.log.data = parseEVTCSource(loaded->source, Settings::GetParserSettingsSnapshot(),
+                    CancellationToken(cancelled, &parseScheduler), result.job.priority == LogPriority::Backlog);
+            }
+            if (cancelled) {
+                break;
+            }
+
+            // Hand the inflated buffer back before waiting on the publisher.
+            loaded.reset();
+
+            LogPriority priority = result.job.priority;
+            parsedLogResults.push(std::move(result), toLane(priority));
+        }
+        catch (const std::exception& ex) {
+            APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+                ("Exception parsing log: " + std::string(ex.what())).c_str());
+            finishJob(job);
+        }
+    }
+}
+
+void ParsePipeline::runPublishStage() {
+    while (auto result = parsedLogResults.pop()) {
+        if (cancelled) {
+            break;
+        }
+
+        try {
+            publish(result->job, std::move(result->log));
+        }
+        catch (const std::exception& ex) {
+            APIDefs->Log(ELogLevel_WARNING, ADDON_NAME,
+                ("Exception publishing log: " + std::string(ex.what())).c_str());
+        }
+        finishJob(result->job);
+    }
+}
@@ -0,0 +1,126 @@
+#include "parser/parse_scheduler.h"
+#include "parser/parse_metrics.h"
+#include "shared/Shared.h"
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+ParseScheduler parseScheduler;
+
+namespace {
+    // Under Throttle a parse thread works for one slice, then sleeps for the
+    // rest, which holds each thread to about a quarter of a core in combat.
+    constexpr auto kCombatSliceBudget = std::chrono::milliseconds(2);
+    constexpr auto kCombatSliceRest = std::chrono::milliseconds(6);
+
+    // Longer gaps are loading screens or a minimised game, not hitches.
+    constexpr auto kMaxRecordedFrame = std::chrono::seconds(1);
+
+    struct WorkerPacing {
+        bool lowered = false;
+        std::chrono::steady_clock::time_point sliceStart{};
+    };
+
+    thread_local WorkerPacing workerPacing;
+
+    void setWorkerPriority(bool lowered) {
+        if (workerPacing.lowered == lowered) {
+            return;
+        }
+        workerPacing.lowered = lowered;
+#ifdef _WIN32
+        SetThreadPriority(GetCurrentThread(), lowered ? THREAD_PRIORITY_LOWEST : THREAD_PRIORITY_NORMAL);
+#endif
+    }
+}
+
+int getCurrentThreadPriority() {
+#ifdef _WIN32
+    return GetThreadPriority(GetCurrentThread());
+#else
+    return 0;
+#endif
+}
+
+void adoptThreadPriority(int priority) {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), priority);
+    workerPacing.lowered = priority == THREAD_PRIORITY_LOWEST;
+#else
+    (void)priority;
+#endif
+}
+
+bool isPlayerInCombat() {
+    return MumbleLink && MumbleLink->Context.IsInCombat;
+}
+
+void ParseScheduler::setPolicy(CombatParsePolicy newPolicy) {
+    policy.store(newPolicy, std::memory_order_relaxed);
+}
+
+CombatParsePolicy ParseScheduler::getPolicy() const {
+    return policy.load(std::memory_order_relaxed);
+}
+
+void ParseScheduler::pace() {
+    CombatParsePolicy current = getPolicy();
+    if (current == CombatParsePolicy::FullSpeed || !isPlayerInCombat()) {
+        setWorkerPriority(false);
+        workerPacing.sliceStart = {};
+        return;
+    }
+
+    setWorkerPriority(true);
+    if (current != CombatParsePolicy::Throttle) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (workerPacing.sliceStart == std::chrono::steady_clock::time_point{}) {
+        workerPacing.sliceStart = now;
+        return;
+    }
+    if (now - workerPacing.sliceStart < kCombatSliceBudget) {
+        return;
+    }
+
+    {
+        ScopedLatency timer(parseMetrics.combatThrottle);
+        std::this_thread::sleep_for(kCombatSliceRest);
+    }
+    workerPacing.sliceStart = std::chrono::steady_clock::now();
+}
+
+void ParseScheduler::recordFrame() {
+    auto now = std::chrono::steady_clock::now();
+    auto previous = lastFrame;
+    lastFrame = now;
+    if (previous == std::chrono::steady_clock::time_point{} || now - previous > kMaxRecordedFrame) {
+        return;
+    }
+
+    bool parsing = busyWorkers.load(std::memory_order_relaxed) > 0;
+    bool inCombat = isPlayerInCombat();
+    if (!parsing) {
+        (inCombat ? parseMetrics.combatIdleFrames : parseMetrics.idleFrames).record(now - previous);
+    }
+    else if (!inCombat) {
+        parseMetrics.parsingFrames.record(now - previous);
+    }
+    else {
+        parseMetrics.combatParsingFrames[static_cast<size_t>(getPolicy())].record(now - previous);
+    }
+}
+
+ParseScheduler::BusyScope::BusyScope(ParseScheduler& scheduler)
+    : scheduler(scheduler) {
+    scheduler.busyWorkers.fetch_add(1, std::memory_order_relaxed);
+    scheduler.pace();
+}
+
+ParseScheduler::BusyScope::~BusyScope() {
+    scheduler.busyWorkers.fetch_sub(1, std::memory_order_relaxed);
+}
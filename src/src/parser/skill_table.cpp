@@ -0,0 +1,68 @@
+#include "parser/skill_table.h"
+#include <algorithm>
+#include <cstring>
+
+SkillNamePool skillNamePool;
+
+namespace {
+    constexpr size_t kSkillEntrySize = 68;
+    constexpr size_t kSkillNameSize = 64;
+}
+
+uint32_t SkillNamePool::intern(uint32_t skillId, std::string_view name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = indexBySkillId.try_emplace(skillId, static_cast<uint32_t>(names.size()));
+    if (inserted) {
+        names.emplace_back(name);
+        skillIds.push_back(skillId);
+    }
+    return it->second;
+}
+
+const std::string& SkillNamePool::getName(uint32_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return names[index];
+}
+
+uint32_t SkillNamePool::getSkillId(uint32_t index) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return skillIds[index];
+}
+
+size_t SkillNamePool::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return names.size();
+}
+
+LogSkillTable parseSkillTable(const char* data, uint32_t skillCount, SkillNamePool& pool) {
+    LogSkillTable table;
+    table.poolIndices.reserve(std::min<uint32_t>(skillCount, LogSkillTable::kNoSkill));
+
+    for (uint32_t i = 0; i < skillCount && table.size() < LogSkillTable::kNoSkill; ++i) {
+        const char* entry = data + static_cast<size_t>(i) * kSkillEntrySize;
+        int32_t skillId;
+        std::memcpy(&skillId, entry, sizeof(int32_t));
+        if (skillId < 0 || static_cast<uint32_t>(skillId) >= kMaxDenseSkillId) {
+            continue;
+        }
+
+        const uint32_t id = static_cast<uint32_t>(skillId);
+        if (id >= table.denseIndexBySkillId.size()) {
+            table.denseIndexBySkillId.resize(id + 1, LogSkillTable::kNoSkill);
+        }
+        else if (table.denseIndexBySkillId[id] != LogSkillTable::kNoSkill) {
+            continue;
+        }
+
+        // Names are null-padded, but not terminated when all 64 bytes are used
+        const char* name = entry + sizeof(int32_t);
+        size_t nameLength = 0;
+        while (nameLength < kSkillNameSize && name[nameLength] != '\0') {
+            ++nameLength;
+        }
+
+        table.denseIndexBySkillId[id] = static_cast<uint16_t>(table.size());
+        table.poolIndices.push_back(pool.intern(id, std::string_view(name, nameLength)));
+    }
+    return table;
+}
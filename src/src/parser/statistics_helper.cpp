@@ -20,145 +20,18 @@ bool isTrackedBoon(uint32_t skillId) {
     }
 }
 
-void updateStats(TeamStats& teamStats, Agent* agent, int32_t value, bool isDamage, bool isKill, bool vsPlayer,
-    bool isStrikeDamage, bool isCondiDamage, bool isDownedContribution, bool isKillContribution, bool isStrip) {
-    auto& specStats = teamStats.eliteSpecStats[agent->eliteSpec];
-
-    if (isDamage) {
-        teamStats.totalDamage += value;
-        specStats.totalDamage += value;
-
-        if (isStrikeDamage) {
-            teamStats.totalStrikeDamage += value;
-            specStats.totalStrikeDamage += value;
-        }
-        else if (isCondiDamage) {
-            teamStats.totalCondiDamage += value;
-            specStats.totalCondiDamage += value;
-        }
-
-        if (vsPlayer) {
-            teamStats.totalDamageVsPlayers += value;
-            specStats.totalDamageVsPlayers += value;
-
-            if (isStrikeDamage) {
-                teamStats.totalStrikeDamageVsPlayers += value;
-                specStats.totalStrikeDamageVsPlayers += value;
-            }
-            else if (isCondiDamage) {
-                teamStats.totalCondiDamageVsPlayers += value;
-                specStats.totalCondiDamageVsPlayers += value;
-            }
-        }
-
-        if (isDownedContribution) {
-            teamStats.totalDownedContribution += value;
-            specStats.totalDownedContribution += value;
-            if (vsPlayer) {
-                teamStats.totalDownedContributionVsPlayers += value;
-                specStats.totalDownedContributionVsPlayers += value;
-            }
-        }
-
-        if (isKillContribution) {
-            teamStats.totalKillContribution += value;
-            specStats.totalKillContribution += value;
-            if (vsPlayer) {
-                teamStats.totalKillContributionVsPlayers += value;
-                specStats.totalKillContributionVsPlayers += value;
-            }
-        }
-    }
-
-    if (isKill) {
-        teamStats.totalKills++;
-        specStats.totalKills++;
-        if (vsPlayer) {
-            teamStats.totalKillsVsPlayers++;
-            specStats.totalKillsVsPlayers++;
-        }
-    }
-
-    if (isStrip) {
-        teamStats.totalStrips++;
-        specStats.totalStrips++;
-
-        if (vsPlayer) {
-            teamStats.totalStripsVsPlayers++;
-            specStats.totalStripsVsPlayers++;
-        }
-    }
-
-    // Handle squad stats if this is the POV team and agent is in a subgroup
-    if (teamStats.isPOVTeam && agent->subgroupNumber > 0) {
-        auto& squadStats = teamStats.squadStats;
-        auto& squadSpecStats = squadStats.eliteSpecStats[agent->eliteSpec];
-
-        if (isDamage) {
-            squadStats.totalDamage += value;
-            squadSpecStats.totalDamage += value;
-
-            if (isStrikeDamage) {
-                squadStats.totalStrikeDamage += value;
-                squadSpecStats.totalStrikeDamage += value;
-            }
-            else if (isCondiDamage) {
-                squadStats.totalCondiDamage += value;
-                squadSpecStats.totalCondiDamage += value;
-            }
-
-            if (vsPlayer) {
-                squadStats.totalDamageVsPlayers += value;
-                squadSpecStats.totalDamageVsPlayers += value;
-
-                if (isStrikeDamage) {
-                    squadStats.totalStrikeDamageVsPlayers += value;
-                    squadSpecStats.totalStrikeDamageVsPlayers += value;
-                }
-                else if (isCondiDamage) {
-                    squadStats.totalCondiDamageVsPlayers += value;
-                    squadSpecStats.totalCondiDamageVsPlayers += value;
-                }
-            }
-
-            if (isDownedContribution) {
-                squadStats.totalDownedContribution += value;
-                squadSpecStats.totalDownedContribution += value;
-                if (vsPlayer) {
-                    squadStats.totalDownedContributionVsPlayers += value;
-                    squadSpecStats.totalDownedContributionVsPlayers += value;
-                }
-            }
-
-            if (isKillContribution) {
-                squadStats.totalKillContribution += value;
-                squadSpecStats.totalKillContribution += value;
-                if (vsPlayer) {
-                    squadStats.totalKillContributionVsPlayers += value;
-                    squadSpecStats.totalKillContributionVsPlayers += value;
-                }
-            }
-        }
-
-        if (isKill) {
-            squadStats.totalKills++;
-            squadSpecStats.totalKills++;
-            if (vsPlayer) {
-                squadStats.totalKillsVsPlayers++;
-                squadSpecStats.totalKillsVsPlayers++;
-            }
-        }
-
-        if (isStrip) {
-            squadStats.totalStrips++;
-            squadSpecStats.totalStrips++;
-
-            if (vsPlayer) {
-                squadStats.totalStripsVsPlayers++;
-                squadSpecStats.totalStripsVsPlayers++;
-            }
+StatBlocks resolveStatBlocks(TeamStats& teamStats, const Agent& agent) {
+    StatBlocks blocks;
+    blocks.team = &teamStats;
+    blocks.spec = &teamStats.eliteSpecStats[agent.eliteSpec];
+    if (teamStats.isPOVTeam && agent.subgroupNumber > 0) {
+        blocks.squad = &teamStats.squadStats;
+        blocks.squadSpec = &teamStats.squadStats.eliteSpecStats[agent.eliteSpec];
+        if (agent.subgroupNumber <= static_cast<int>(kMaxSubgroups)) {
+            blocks.subgroup = &teamStats.squadStats.subgroupStats[agent.subgroupNumber - 1];
         }
     }
+    return blocks;
 }
 
 bool isDamageInDownSequence(const Agent* agent, const AgentState& state, uint64_t currentTime) {
@@ -175,10 +48,9 @@ bool isDamageInDownSequence(const Agent* agent, const AgentState& state, uint64_
 
     // Find next down using original sequence
     uint64_t nextDownTime = UINT64_MAX;
-    for (const auto& event : state.relevantEvents) {
-        if (event.time > currentTime &&
-            event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDown)) {
-            nextDownTime = event.time;
+    for (const auto& record : state.records) {
+        if (record.time > currentTime && record.kind == AgentStateKind::Down) {
+            nextDownTime = record.time;
             break;
         }
     }
@@ -187,15 +59,13 @@ bool isDamageInDownSequence(const Agent* agent, const AgentState& state, uint64_
 
     // Find last high health using original sequence
     uint64_t lastHighHealthTime = 0;
-    for (auto it = state.relevantEvents.rbegin(); it != state.relevantEvents.rend(); ++it) {
-        const auto& event = *it;
-        if (event.time >= currentTime) continue;
-
-        if (event.isStateChange == static_cast<uint8_t>(StateChange::HealthUpdate)) {
-            if (event.value > 0 && (event.dstAgent * 100.0f) / event.value > 98.0f) {
-                lastHighHealthTime = event.time;
-                break;
-            }
+    for (auto it = state.records.rbegin(); it != state.records.rend(); ++it) {
+        const auto& record = *it;
+        if (record.time >= currentTime) continue;
+
+        if (record.kind == AgentStateKind::Health && record.healthPermille > 980) {
+            lastHighHealthTime = record.time;
+            break;
         }
     }
 
@@ -214,15 +84,14 @@ bool isDamageInKillSequence(const Agent* agent, const AgentState& state, uint64_
     bool currentlyDowned = false;
     uint64_t downTime = 0;
 
-    for (const auto& event : state.relevantEvents) {
-        if (event.time >= currentTime) break;
+    for (const auto& record : state.records) {
+        if (record.time >= currentTime) break;
 
-        if (event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDown)) {
+        if (record.kind == AgentStateKind::Down) {
             currentlyDowned = true;
-            downTime = event.time;
+            downTime = record.time;
         }
-        else if (event.isStateChange == static_cast<uint8_t>(StateChange::ChangeUp) ||
-            event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDead)) {
+        else if (record.kind == AgentStateKind::Up || record.kind == AgentStateKind::Dead) {
             currentlyDowned = false;
         }
     }
@@ -231,10 +100,9 @@ bool isDamageInKillSequence(const Agent* agent, const AgentState& state, uint64_
 
     // Find next death after current down
     uint64_t deathTime = UINT64_MAX;
-    for (const auto& event : state.relevantEvents) {
-        if (event.time > currentTime &&
-            event.isStateChange == static_cast<uint8_t>(StateChange::ChangeDead)) {
-            deathTime = event.time;
+    for (const auto& record : state.records) {
+        if (record.time > currentTime && record.kind == AgentStateKind::Dead) {
+            deathTime = record.time;
             break;
         }
     }
@@ -244,3 +112,408 @@ bool isDamageInKillSequence(const Agent* agent, const AgentState& state, uint64_
     return currentTime >= downTime - TWO_SECONDS &&
         currentTime <= deathTime;
 }
+
+namespace {
+    void mergeSpecStats(SpecStats& into, const SpecStats& from) {
+        into.count += from.count;
+        into.totalKills += from.totalKills;
+        into.totalKillsVsPlayers += from.totalKillsVsPlayers;
+        into.totalDeaths += from.totalDeaths;
+        into.totalDowned += from.totalDowned;
+        into.totalDamage += from.totalDamage;
+        into.totalStrips += from.totalStrips;
+        into.totalStripsVsPlayers += from.totalStripsVsPlayers;
+        into.totalStrikeDamage += from.totalStrikeDamage;
+        into.totalCondiDamage += from.totalCondiDamage;
+        into.totalDamageVsPlayers += from.totalDamageVsPlayers;
+        into.totalStrikeDamageVsPlayers += from.totalStrikeDamageVsPlayers;
+        into.totalCondiDamageVsPlayers += from.totalCondiDamageVsPlayers;
+        into.totalDownedContribution += from.totalDownedContribution;
+        into.totalDownedContributionVsPlayers += from.totalDownedContributionVsPlayers;
+        into.totalKillContribution += from.totalKillContribution;
+        into.totalKillContributionVsPlayers += from.totalKillContributionVsPlayers;
+    }
+
+    // TeamStats and SquadStats share these counters.
+    template <typename Stats>
+    void mergeSquadCounters(Stats& into, const Stats& from) {
+        into.totalPlayers += from.totalPlayers;
+        into.totalDeaths += from.totalDeaths;
+        into.totalDowned += from.totalDowned;
+        into.totalKills += from.totalKills;
+        into.totalDeathsFromKillingBlows += from.totalDeathsFromKillingBlows;
+        into.totalDamage += from.totalDamage;
+        into.totalStrips += from.totalStrips;
+        into.totalStripsVsPlayers += from.totalStripsVsPlayers;
+        into.totalStrikeDamage += from.totalStrikeDamage;
+        into.totalCondiDamage += from.totalCondiDamage;
+        into.totalDamageVsPlayers += from.totalDamageVsPlayers;
+        into.totalStrikeDamageVsPlayers += from.totalStrikeDamageVsPlayers;
+        into.totalCondiDamageVsPlayers += from.totalCondiDamageVsPlayers;
+        into.totalKillsVsPlayers += from.totalKillsVsPlayers;
+        into.totalDownedContribution += from.totalDownedContribution;
+        into.totalDownedContributionVsPlayers += from.totalDownedContributionVsPlayers;
+        into.totalKillContribution += from.totalKillContribution;
+        into.totalKillContributionVsPlayers += from.totalKillContributionVsPlayers;
+        into.timeWeightedPlayers += from.timeWeightedPlayers;
+
+        for (const auto& [eliteSpec, specStats] : from.eliteSpecStats) {
+            mergeSpecStats(into.eliteSpecStats[eliteSpec], specStats);
+        }
+    }
+
+    // The SpecCounters running totals next to the SpecStats counters they
+    // stand for, by SpecStats counter width
+    constexpr std::pair<uint32_t SpecCounters::*, uint32_t SpecStats::*> kRangeCounters32[] = {
+        { &SpecCounters::totalKills, &SpecStats::totalKills },
+        { &SpecCounters::totalKillsVsPlayers, &SpecStats::totalKillsVsPlayers },
+        { &SpecCounters::totalDeaths, &SpecStats::totalDeaths },
+        { &SpecCounters::totalDowned, &SpecStats::totalDowned },
+    };
+
+    constexpr std::pair<uint32_t SpecCounters::*, uint64_t SpecStats::*> kRangeCounters64[] = {
+        { &SpecCounters::totalDamage, &SpecStats::totalDamage },
+        { &SpecCounters::totalStrips, &SpecStats::totalStrips },
+        { &SpecCounters::totalStripsVsPlayers, &SpecStats::totalStripsVsPlayers },
+        { &SpecCounters::totalStrikeDamage, &SpecStats::totalStrikeDamage },
+        { &SpecCounters::totalCondiDamage, &SpecStats::totalCondiDamage },
+        { &SpecCounters::totalDamageVsPlayers, &SpecStats::totalDamageVsPlayers },
+        { &SpecCounters::totalStrikeDamageVsPlayers, &SpecStats::totalStrikeDamageVsPlayers },
+        { &SpecCounters::totalCondiDamageVsPlayers, &SpecStats::totalCondiDamageVsPlayers },
+        { &SpecCounters::totalDownedContribution, &SpecStats::totalDownedContribution },
+        { &SpecCounters::totalDownedContributionVsPlayers, &SpecStats::totalDownedContributionVsPlayers },
+        { &SpecCounters::totalKillContribution, &SpecStats::totalKillContribution },
+        { &SpecCounters::totalKillContributionVsPlayers, &SpecStats::totalKillContributionVsPlayers },
+    };
+
+    template <typename T>
+    void addRow(T& into, T from) {
+        into += from;
+    }
+
+    void addRow(SpecCounters& into, const SpecCounters& from) {
+        for (const auto& [counter, _] : kRangeCounters32) {
+            into.*counter += from.*counter;
+        }
+        for (const auto& [counter, _] : kRangeCounters64) {
+            into.*counter += from.*counter;
+        }
+    }
+
+    template <typename T>
+    void addSeries(std::vector<T>& into, const std::vector<T>& from) {
+        if (into.size() < from.size()) {
+            into.resize(from.size());
+        }
+        for (size_t i = 0; i < from.size(); ++i) {
+            addRow(into[i], from[i]);
+        }
+    }
+
+    template <typename T>
+    void runningTotals(std::vector<T>& series) {
+        for (size_t i = 1; i < series.size(); ++i) {
+            addRow(series[i], series[i - 1]);
+        }
+    }
+
+    // Fills into with full's player counts and the counters of rows
+    // [first, end) of the index.
+    template <typename Stats>
+    void sliceSquad(Stats& into, const Stats& full, const FightRangeIndex::Squad* index,
+        size_t first, size_t end) {
+        into.totalPlayers = full.totalPlayers;
+        into.timeWeightedPlayers = full.timeWeightedPlayers;
+        for (const auto& [eliteSpec, specStats] : full.eliteSpecStats) {
+            into.eliteSpecStats[eliteSpec].count = specStats.count;
+        }
+        if (!index) {
+            return;
+        }
+
+        for (const auto& [eliteSpec, rows] : index->specs) {
+            SpecStats& specStats = into.eliteSpecStats[eliteSpec];
+            for (const auto& [counter, field] : kRangeCounters32) {
+                specStats.*field = rows[end].*counter - rows[first].*counter;
+            }
+            for (const auto& [counter, field] : kRangeCounters64) {
+                specStats.*field = static_cast<uint32_t>(rows[end].*counter - rows[first].*counter);
+            }
+            addSpecCounters(into, specStats);
+        }
+        if (!index->deathsFromKillingBlows.empty()) {
+            into.totalDeathsFromKillingBlows =
+                index->deathsFromKillingBlows[end] - index->deathsFromKillingBlows[first];
+        }
+    }
+
+    void mergeTimeline(TeamTimeline& into, const TeamTimeline& from) {
+        addSeries(into.damage, from.damage);
+        addSeries(into.damageVsPlayers, from.damageVsPlayers);
+        addSeries(into.downs, from.downs);
+        addSeries(into.deaths, from.deaths);
+        addSeries(into.strips, from.strips);
+        addSeries(into.players, from.players);
+    }
+
+    bool sameTimeline(const TeamTimeline& a, const TeamTimeline& b) {
+        return a.damage == b.damage &&
+            a.damageVsPlayers == b.damageVsPlayers &&
+            a.downs == b.downs &&
+            a.deaths == b.deaths &&
+            a.strips == b.strips &&
+            a.players == b.players;
+    }
+
+    bool sameSpecStats(const SpecStats& a, const SpecStats& b) {
+        return a.count == b.count &&
+            a.totalKills == b.totalKills &&
+            a.totalKillsVsPlayers == b.totalKillsVsPlayers &&
+            a.totalDeaths == b.totalDeaths &&
+            a.totalDowned == b.totalDowned &&
+            a.totalDamage == b.totalDamage &&
+            a.totalStrips == b.totalStrips &&
+            a.totalStripsVsPlayers == b.totalStripsVsPlayers &&
+            a.totalStrikeDamage == b.totalStrikeDamage &&
+            a.totalCondiDamage == b.totalCondiDamage &&
+            a.totalDamageVsPlayers == b.totalDamageVsPlayers &&
+            a.totalStrikeDamageVsPlayers == b.totalStrikeDamageVsPlayers &&
+            a.totalCondiDamageVsPlayers == b.totalCondiDamageVsPlayers &&
+            a.totalDownedContribution == b.totalDownedContribution &&
+            a.totalDownedContributionVsPlayers == b.totalDownedContributionVsPlayers &&
+            a.totalKillContribution == b.totalKillContribution &&
+            a.totalKillContributionVsPlayers == b.totalKillContributionVsPlayers;
+    }
+
+    template <typename Stats>
+    bool sameSquadCounters(const Stats& a, const Stats& b) {
+        if (a.totalPlayers != b.totalPlayers ||
+            a.totalDeaths != b.totalDeaths ||
+            a.totalDowned != b.totalDowned ||
+            a.totalKills != b.totalKills ||
+            a.totalDeathsFromKillingBlows != b.totalDeathsFromKillingBlows ||
+            a.totalDamage != b.totalDamage ||
+            a.totalStrips != b.totalStrips ||
+            a.totalStripsVsPlayers != b.totalStripsVsPlayers ||
+            a.totalStrikeDamage != b.totalStrikeDamage ||
+            a.totalCondiDamage != b.totalCondiDamage ||
+            a.totalDamageVsPlayers != b.totalDamageVsPlayers ||
+            a.totalStrikeDamageVsPlayers != b.totalStrikeDamageVsPlayers ||
+            a.totalCondiDamageVsPlayers != b.totalCondiDamageVsPlayers ||
+            a.totalKillsVsPlayers != b.totalKillsVsPlayers ||
+            a.totalDownedContribution != b.totalDownedContribution ||
+            a.totalDownedContributionVsPlayers != b.totalDownedContributionVsPlayers ||
+            a.totalKillContribution != b.totalKillContribution ||
+            a.totalKillContributionVsPlayers != b.totalKillContributionVsPlayers ||
+            a.timeWeightedPlayers != b.timeWeightedPlayers ||
+            a.eliteSpecStats.size() != b.eliteSpecStats.size()) {
+            return false;
+        }
+
+        for (const auto& [eliteSpec, specStats] : a.eliteSpecStats) {
+            auto it = b.eliteSpecStats.find(eliteSpec);
+            if (it == b.eliteSpecStats.end() || !sameSpecStats(specStats, it->second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+std::string resolveTeamName(uint32_t teamId, const std::unordered_map<uint32_t, std::string>& logTeamNames,
+    const std::unordered_map<int, std::string>& teamIDs) {
+    auto logIt = logTeamNames.find(teamId);
+    if (logIt != logTeamNames.end()) {
+        return logIt->second;
+    }
+    auto settingsIt = teamIDs.find(static_cast<int>(teamId));
+    if (settingsIt != teamIDs.end()) {
+        return settingsIt->second;
+    }
+    return {};
+}
+
+void mergeTeamStats(TeamStats& into, const TeamStats& from) {
+    mergeSquadCounters(into, from);
+    mergeSquadCounters(into.squadStats, from.squadStats);
+    for (size_t i = 0; i < kMaxSubgroups; ++i) {
+        mergeSpecStats(into.squadStats.subgroupStats[i], from.squadStats.subgroupStats[i]);
+    }
+    mergeTimeline(into.timeline, from.timeline);
+    for (const auto& [skillId, strips] : from.stripsBySkill) {
+        into.stripsBySkill[skillId] += strips;
+    }
+    into.isPOVTeam = into.isPOVTeam || from.isPOVTeam;
+}
+
+bool sameTeamStats(const std::unordered_map<uint32_t, TeamStats>& a,
+    const std::unordered_map<uint32_t, TeamStats>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (const auto& [teamId, stats] : a) {
+        auto it = b.find(teamId);
+        if (it == b.end() || stats.isPOVTeam != it->second.isPOVTeam ||
+            !sameSquadCounters(stats, it->second) ||
+            !sameSquadCounters(stats.squadStats, it->second.squadStats) ||
+            !std::equal(stats.squadStats.subgroupStats.begin(), stats.squadStats.subgroupStats.end(),
+                it->second.squadStats.subgroupStats.begin(), sameSpecStats) ||
+            !sameTimeline(stats.timeline, it->second.timeline) ||
+            stats.stripsBySkill != it->second.stripsBySkill) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void mergePlayerCounters(PlayerCounters& into, const PlayerCounters& from) {
+    for (size_t i = 0; i < into.columns.size(); ++i) {
+        addSeries(into.columns[i], from.columns[i]);
+    }
+}
+
+void mergeSkillCounters(SkillCounters& into, const SkillCounters& from) {
+    addSeries(into.damage, from.damage);
+    addSeries(into.damageVsPlayers, from.damageVsPlayers);
+    addSeries(into.strips, from.strips);
+}
+
+void finishSkillStats(const SkillCounters& counters, const LogSkillTable& skills, SkillStatsTable& table) {
+    for (size_t group = 0; group < table.groups.size(); ++group) {
+        std::vector<SkillTotals>& totals = table.groups[group].skills;
+        const size_t firstCell = group * counters.skillCount;
+        for (size_t skill = 0; skill < counters.skillCount; ++skill) {
+            const size_t cell = firstCell + skill;
+            if (counters.damage[cell] != 0 || counters.strips[cell] != 0) {
+                totals.push_back({ skills.poolIndices[skill], counters.damage[cell],
+                    counters.damageVsPlayers[cell], counters.strips[cell] });
+            }
+        }
+        std::sort(totals.begin(), totals.end(), [](const SkillTotals& a, const SkillTotals& b) {
+            return a.damage != b.damage ? a.damage > b.damage : a.skill < b.skill;
+        });
+        totals.shrink_to_fit();
+    }
+}
+
+std::vector<SkillTotals> sumSpecSkills(const SkillStatsTable& table, const std::vector<uint32_t>& teamIDs,
+    const std::string& eliteSpec, bool squadOnly, bool vsPlayers, size_t count) {
+    std::vector<SkillTotals> sums;
+    std::unordered_map<uint32_t, size_t> sumBySkill;
+    for (const auto& group : table.groups) {
+        if (group.eliteSpec != eliteSpec || (squadOnly && !group.inSquad) ||
+            std::find(teamIDs.begin(), teamIDs.end(), group.teamID) == teamIDs.end()) {
+            continue;
+        }
+        for (const SkillTotals& skill : group.skills) {
+            auto [it, inserted] = sumBySkill.try_emplace(skill.skill, sums.size());
+            if (inserted) {
+                sums.push_back({ skill.skill });
+            }
+            SkillTotals& sum = sums[it->second];
+            sum.damage += skill.damage;
+            sum.damageVsPlayers += skill.damageVsPlayers;
+            sum.strips += skill.strips;
+        }
+    }
+
+    auto damageOf = [vsPlayers](const SkillTotals& skill) {
+        return vsPlayers ? skill.damageVsPlayers : skill.damage;
+    };
+    sums.erase(std::remove_if(sums.begin(), sums.end(), [&](const SkillTotals& skill) {
+        return damageOf(skill) == 0 && skill.strips == 0;
+    }), sums.end());
+
+    count = std::min(count, sums.size());
+    std::partial_sort(sums.begin(), sums.begin() + count, sums.end(),
+        [&](const SkillTotals& a, const SkillTotals& b) {
+            if (damageOf(a) != damageOf(b)) {
+                return damageOf(a) > damageOf(b);
+            }
+            return a.strips != b.strips ? a.strips > b.strips : a.skill < b.skill;
+        });
+    sums.resize(count);
+    return sums;
+}
+
+void mergeRangeIndex(FightRangeIndex& into, const FightRangeIndex& from) {
+    auto mergeSquad = [](FightRangeIndex::Squad& squadInto, const FightRangeIndex::Squad& squadFrom) {
+        for (const auto& [eliteSpec, rows] : squadFrom.specs) {
+            addSeries(squadInto.specs[eliteSpec], rows);
+        }
+        addSeries(squadInto.deathsFromKillingBlows, squadFrom.deathsFromKillingBlows);
+    };
+    for (const auto& [teamId, team] : from.teams) {
+        FightRangeIndex::Team& teamInto = into.teams[teamId];
+        mergeSquad(teamInto.totals, team.totals);
+        mergeSquad(teamInto.povSquad, team.povSquad);
+    }
+}
+
+void finishRangeIndex(FightRangeIndex& index) {
+    for (auto& [_, team] : index.teams) {
+        for (FightRangeIndex::Squad* squad : { &team.totals, &team.povSquad }) {
+            for (auto& [eliteSpec, rows] : squad->specs) {
+                runningTotals(rows);
+            }
+            runningTotals(squad->deathsFromKillingBlows);
+        }
+    }
+}
+
+ParsedData sliceParsedData(const ParsedData& data, size_t firstBucket, size_t endBucket,
+    const std::unordered_map<int, std::string>& teamIDs) {
+    ParsedData sliced;
+    sliced.logTeamNames = data.logTeamNames;
+    sliced.combatStartTime = data.combatStartTime;
+    sliced.combatEndTime = data.combatEndTime;
+    sliced.logStartUnix = data.logStartUnix;
+    sliced.logEndUnix = data.logEndUnix;
+    sliced.fightId = data.fightId;
+    sliced.rangeIndex = data.rangeIndex;
+    sliced.players = data.players;
+    sliced.skills = data.skills;
+
+    const FightRangeIndex* index = data.rangeIndex.get();
+    size_t bucketCount = index ? index->bucketCount : 0;
+    endBucket = std::min(endBucket, bucketCount);
+    firstBucket = std::min(firstBucket, endBucket);
+
+    for (const auto& [teamId, fullStats] : data.teamStatsById) {
+        const FightRangeIndex::Team* teamIndex = nullptr;
+        if (index) {
+            auto it = index->teams.find(teamId);
+            teamIndex = it != index->teams.end() ? &it->second : nullptr;
+        }
+
+        TeamStats& stats = sliced.teamStatsById[teamId];
+        stats.isPOVTeam = fullStats.isPOVTeam;
+        stats.timeline = fullStats.timeline;
+        stats.squadStats.subgroupStats = fullStats.squadStats.subgroupStats;
+        stats.stripsBySkill = fullStats.stripsBySkill;
+        sliceSquad(stats, fullStats, teamIndex ? &teamIndex->totals : nullptr, firstBucket, endBucket);
+        sliceSquad(stats.squadStats, fullStats.squadStats, teamIndex ? &teamIndex->povSquad : nullptr,
+            firstBucket, endBucket);
+    }
+
+    resolveTeamStats(sliced, teamIDs);
+    return sliced;
+}
+
+void resolveTeamStats(ParsedData& data, const std::unordered_map<int, std::string>& teamIDs) {
+    data.teamStats.clear();
+    data.totalIdentifiedPlayers = 0;
+
+    for (const auto& [teamId, stats] : data.teamStatsById) {
+        std::string teamName = resolveTeamName(teamId, data.logTeamNames, teamIDs);
+        if (teamName.empty()) {
+            continue;
+        }
+
+        auto [it, inserted] = data.teamStats.try_emplace(teamName, stats);
+        if (!inserted) {
+            mergeTeamStats(it->second, stats);
+        }
+        data.totalIdentifiedPlayers += stats.totalPlayers;
+    }
+}
@@ -15,6 +15,8 @@ const char* TEAM_PLAYER_THRESHOLD = "TeamPlayerThreshold";
 const char* SHOW_NEW_PARSE_ALERT = "ShowNewParseAlert";
 const char* FORCE_LINUX_COMPAT = "ForceLinuxCompat";
 const char* POLL_INTERVAL_MILLISECONDS = "PollIntervalMilliseconds";
+const char* PARSER_WORKER_COUNT = "ParserWorkerCount";
+const char* COMBAT_PARSE_POLICY = "CombatParsePolicy";
 const char* USE_NEXUS_ESC_CLOSE = "UseNexusEscClose";
 const char* DEBUG_STRINGS_MODE = "debugStringsMode";
 const char* TEAM_IDS = "TeamIDs";
@@ -144,6 +146,7 @@ json MainWindowSettings::toJson() const {
 
     // Basic display settings
     j["showLogName"] = showLogName;
+    j["showTimeRange"] = showTimeRange;
     j["useShortClassNames"] = useShortClassNames;
     j["showSpecBars"] = showSpecBars;
     j["showSpecTooltips"] = showSpecTooltips;
@@ -165,6 +168,10 @@ json MainWindowSettings::toJson() const {
     j["showTeamStrikeDamage"] = showTeamStrikeDamage;
     j["showTeamCondiDamage"] = showTeamCondiDamage;
     j["showTeamStrips"] = showTeamStrips;
+    j["showTeamTimeline"] = showTeamTimeline;
+    j["showTopPlayers"] = showTopPlayers;
+    j["topPlayersCount"] = topPlayersCount;
+    j["showSubgroups"] = showSubgroups;
 
     j["barCornerRounding"] = barCornerRounding;
     j["overideTableBackgroundStyle"] = overideTableBackgroundStyle;
@@ -246,6 +253,7 @@ MainWindowSettings::MainWindowSettings(const json& j) : BaseWindowSettings(j, "w
 
     if (!j.is_null()) {
         showLogName = j.value("showLogName", showLogName);
+        showTimeRange = j.value("showTimeRange", showTimeRange);
         useShortClassNames = j.value("useShortClassNames", useShortClassNames);
         showSpecBars = j.value("showSpecBars", showSpecBars);
         showSpecTooltips = j.value("showSpecTooltips", showSpecTooltips);
@@ -266,6 +274,10 @@ MainWindowSettings::MainWindowSettings(const json& j) : BaseWindowSettings(j, "w
         showTeamStrikeDamage = j.value("showTeamStrikeDamage", showTeamStrikeDamage);
         showTeamCondiDamage = j.value("showTeamCondiDamage", showTeamCondiDamage);
         showTeamStrips = j.value("showTeamStrips", showTeamStrips);
+        showTeamTimeline = j.value("showTeamTimeline", showTeamTimeline);
+        showTopPlayers = j.value("showTopPlayers", showTopPlayers);
+        topPlayersCount = std::clamp(j.value("topPlayersCount", topPlayersCount), 1, 20);
+        showSubgroups = j.value("showSubgroups", showSubgroups);
 
         barCornerRounding = j.value("barCornerRounding", barCornerRounding);
         overideTableBackgroundStyle = j.value("overideTableBackgroundStyle", overideTableBackgroundStyle);
@@ -466,6 +478,8 @@ namespace Settings {
     bool showNewParseAlert = true;
     bool forceLinuxCompatibilityMode = false;
     size_t pollIntervalMilliseconds = 3000;
+    size_t parserWorkerCount = 2;
+    int combatParsePolicy = 1;
     bool hideAggWhenEmpty = false;
     bool useNexusEscClose = false;
     bool debugStringsMode = false;
@@ -506,6 +520,12 @@ namespace Settings {
                 if (!Settings.contains(POLL_INTERVAL_MILLISECONDS)) {
                     Settings[POLL_INTERVAL_MILLISECONDS] = 3000;
                 }
+                if (!Settings.contains(PARSER_WORKER_COUNT)) {
+                    Settings[PARSER_WORKER_COUNT] = 2;
+                }
+                if (!Settings.contains(COMBAT_PARSE_POLICY)) {
+                    Settings[COMBAT_PARSE_POLICY] = 1;
+                }
                 if (!Settings.contains(USE_NEXUS_ESC_CLOSE)) {
                     Settings[USE_NEXUS_ESC_CLOSE] = false;
                 }
@@ -603,6 +623,22 @@ namespace Settings {
                     Settings[POLL_INTERVAL_MILLISECONDS] = 3000;
                 }
 
+                try {
+                    parserWorkerCount = std::clamp<size_t>(Settings[PARSER_WORKER_COUNT].get<size_t>(), 1, 8);
+                }
+                catch (...) {
+                    parserWorkerCount = 2;
+                    Settings[PARSER_WORKER_COUNT] = 2;
+                }
+
+                try {
+                    combatParsePolicy = std::clamp(Settings[COMBAT_PARSE_POLICY].get<int>(), 0, 2);
+                }
+                catch (...) {
+                    combatParsePolicy = 1;
+                    Settings[COMBAT_PARSE_POLICY] = 1;
+                }
+
                 try {
                     useNexusEscClose = Settings[USE_NEXUS_ESC_CLOSE].get<bool>();
                 }
@@ -701,6 +737,8 @@ namespace Settings {
                 showNewParseAlert = true;
                 forceLinuxCompatibilityMode = false;
                 pollIntervalMilliseconds = 3000;
+                parserWorkerCount = 2;
+                combatParsePolicy = 1;
                 hideAggWhenEmpty = false;
                 useNexusEscClose = false;
                 debugStringsMode = false;
@@ -718,6 +756,8 @@ namespace Settings {
                 Settings[SHOW_NEW_PARSE_ALERT] = showNewParseAlert;
                 Settings[FORCE_LINUX_COMPAT] = forceLinuxCompatibilityMode;
                 Settings[POLL_INTERVAL_MILLISECONDS] = pollIntervalMilliseconds;
+                Settings[PARSER_WORKER_COUNT] = parserWorkerCount;
+                Settings[COMBAT_PARSE_POLICY] = combatParsePolicy;
                 Settings[USE_NEXUS_ESC_CLOSE] = useNexusEscClose;
                 Settings[DEBUG_STRINGS_MODE] = debugStringsMode;
                 Settings[SCRAPPER_ICON_STYLE] = scrapperIconStyle;
@@ -796,6 +836,8 @@ namespace Settings {
         snapshot.showNewParseAlert = showNewParseAlert;
         snapshot.forceLinuxCompatibilityMode = forceLinuxCompatibilityMode;
         snapshot.pollIntervalMilliseconds = pollIntervalMilliseconds;
+        snapshot.parserWorkerCount = parserWorkerCount;
+        snapshot.combatParsePolicy = combatParsePolicy;
         snapshot.debugStringsMode = debugStringsMode;
         snapshot.teamIDs = teamIDs;
         return snapshot;
@@ -820,6 +862,7 @@ namespace Settings {
 
             // Display settings
             mainWindow->showLogName = true;
+            mainWindow->showTimeRange = false;
             mainWindow->useShortClassNames = false;
             mainWindow->showSpecBars = true;
             mainWindow->showSpecTooltips = true;
@@ -839,6 +882,10 @@ namespace Settings {
             mainWindow->showTeamStrikeDamage = false;
             mainWindow->showTeamCondiDamage = false;
             mainWindow->showTeamStrips = false;
+            mainWindow->showTeamTimeline = false;
+            mainWindow->showTopPlayers = false;
+            mainWindow->topPlayersCount = 5;
+            mainWindow->showSubgroups = false;
 
             // Exclusions
             mainWindow->excludeRedTeam = false;